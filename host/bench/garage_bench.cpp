@@ -0,0 +1,142 @@
+// garage_bench.cpp
+// Google Benchmark front end for the firmware's MicroBench cases: the
+// same case functions the device runs, registered here by name so the
+// results can be saved as JSON and compared by tools/bench_compare.py.
+// Host-only families (rule engine scaling) are defined below them.
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "AlarmRules.h"
+#include "MicroBench.h"
+
+// ============================================
+// ALLOCATION COUNTER
+// ============================================
+// Every replaceable form is malloc/free based, so any new pairs with
+// any delete. The bodies are kept out of line: inlined into a caller,
+// GCC would see a new'd pointer reach free() (-Wmismatched-new-delete).
+static std::atomic<uint64_t> allocations(0);
+
+__attribute__((noinline)) static void* countedAlloc(size_t size, size_t align) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (size == 0) size = 1;
+  if (align <= alignof(std::max_align_t)) return malloc(size);
+  return aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+__attribute__((noinline)) static void countedFree(void* p) {
+  free(p);
+}
+
+static void* countedNew(size_t size, size_t align = alignof(std::max_align_t)) {
+  void* p = countedAlloc(size, align);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(size_t size) { return countedNew(size); }
+void* operator new[](size_t size) { return countedNew(size); }
+void* operator new(size_t size, std::align_val_t align) { return countedNew(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align) { return countedNew(size, (size_t)align); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return countedAlloc(size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return countedAlloc(size, alignof(std::max_align_t));
+}
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+
+// ============================================
+// FIXTURES
+// ============================================
+static WiFiClient offlineNet;
+static PubSubClient offlineMqtt(offlineNet);
+static MicroBench suite(offlineMqtt);
+static PushsaferNotifier push;
+static ThingSpeakLogger cloud;
+
+static void runCase(benchmark::State& state, BenchCase bench) {
+  bench.fn(bench.context);   // warm-up: lazy statics
+
+  uint64_t before = allocations.load(std::memory_order_relaxed);
+  for (auto _ : state) {
+    bench.fn(bench.context);
+  }
+  uint64_t allocs = allocations.load(std::memory_order_relaxed) - before;
+
+  state.counters["allocs_per_op"] = benchmark::Counter((double)allocs, benchmark::Counter::kAvgIterations);
+}
+
+// ============================================
+// RULE ENGINE SCALING
+// ============================================
+// Copies of the live table with varied windows, so aggregates do not
+// all merge and the cost reflects distinct rules. rules.scaling/N is
+// one evaluate() with N rules; the complexity fit gives cost per rule.
+static AlarmRule scalingRules[RULE_MAX_RULES];
+
+static void buildScalingRules() {
+  for (uint8_t r = 0; r < RULE_MAX_RULES; r++) {
+    scalingRules[r] = ALARM_RULES[r % ALARM_RULE_COUNT];
+    for (uint8_t t = 0; t < RULE_MAX_TERMS; t++) {
+      RuleTerm& term = scalingRules[r].terms[t];
+      if (term.window == 0) break;
+      if (term.aggregate == RULE_AGG_LAST) term.aggregate = RULE_AGG_MAX;
+      term.window = 1 + (r + t) % RULE_WINDOW_MAX;
+    }
+  }
+}
+
+static void ruleScaling(benchmark::State& state) {
+  static AlarmRuleEngine engine;
+  uint8_t count = state.range(0);
+  engine.begin(scalingRules, count, nullptr);
+
+  float inputs[RULE_IN_COUNT];
+  uint32_t i = 0;
+  uint64_t before = allocations.load(std::memory_order_relaxed);
+  for (auto _ : state) {
+    inputs[RULE_IN_TEMPERATURE] = 20 + (i % 100) * 0.5;
+    inputs[RULE_IN_HUMIDITY] = 60;
+    inputs[RULE_IN_SMOKE] = (i * 7) % 1000;
+    inputs[RULE_IN_PIR] = (i & 16) ? 1 : 0;
+    inputs[RULE_IN_DOORS_CLOSED] = 1;
+    engine.evaluate(inputs, i * SENSOR_READ_INTERVAL);
+    i++;
+  }
+  uint64_t allocs = allocations.load(std::memory_order_relaxed) - before;
+
+  state.SetComplexityN(count);
+  state.counters["allocs_per_op"] = benchmark::Counter((double)allocs, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(ruleScaling)->Name("rules.scaling")->RangeMultiplier(2)->Range(1, RULE_MAX_RULES)
+                      ->Complexity(benchmark::oN);
+
+int main(int argc, char** argv) {
+  buildScalingRules();
+  cloud.begin(CLOUD_CHANNELS, CLOUD_CHANNEL_COUNT, CLOUD_FIELDS, CLOUD_FIELD_COUNT);
+  suite.addFirmwareCases(push, cloud);
+
+  for (uint8_t i = 0; i < suite.count(); i++) {
+    const BenchCase& bench = suite.at(i);
+    benchmark::RegisterBenchmark(bench.name, runCase, bench);
+  }
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,278 @@
+// PubSubClient.cpp (host fleet)
+#include "PubSubClient.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define MQTT_CONNECT     0x10
+#define MQTT_CONNACK     0x20
+#define MQTT_PUBLISH     0x30
+#define MQTT_SUBSCRIBE   0x82
+#define MQTT_PINGREQ     0xC0
+#define MQTT_PINGRESP    0xD0
+#define MQTT_DISCONNECT  0xE0
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+PubSubClient::PubSubClient() {
+  host = "localhost";
+  port = 1883;
+  fd = -1;
+  nextPacketId = 1;
+  lastOutbound = 0;
+  lastInbound = 0;
+  pingOutstanding = false;
+}
+
+PubSubClient::PubSubClient(WiFiClient&) : PubSubClient() {}
+
+PubSubClient::~PubSubClient() {
+  closeSocket();
+}
+
+PubSubClient& PubSubClient::setServer(const char* serverHost, uint16_t serverPort) {
+  host = serverHost;
+  port = serverPort;
+  return *this;
+}
+
+PubSubClient& PubSubClient::setCallback(Callback cb) {
+  callback = cb;
+  return *this;
+}
+
+// ============================================
+// CONNECTION
+// ============================================
+
+bool PubSubClient::connect(const char* id) {
+  closeSocket();
+
+  char service[8];
+  snprintf(service, sizeof(service), "%u", port);
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* addrs = nullptr;
+  if (getaddrinfo(host, service, &hints, &addrs) != 0) return false;
+
+  for (struct addrinfo* a = addrs; a != nullptr && fd < 0; a = a->ai_next) {
+    fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+    if (fd < 0) continue;
+    if (::connect(fd, a->ai_addr, a->ai_addrlen) != 0) closeSocket();
+  }
+  freeaddrinfo(addrs);
+  if (fd < 0) return false;
+
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  struct timeval timeout = { MQTT_SOCKET_TIMEOUT, 0 };
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  // Protocol "MQTT" level 4, clean session, no will/credentials
+  std::vector<uint8_t> body;
+  appendString(body, "MQTT");
+  body.push_back(4);
+  body.push_back(0x02);
+  body.push_back(MQTT_KEEPALIVE >> 8);
+  body.push_back(MQTT_KEEPALIVE & 0xff);
+  appendString(body, id);
+  if (!sendPacket(MQTT_CONNECT, body)) return false;
+
+  uint8_t connack[4];
+  size_t got = 0;
+  while (got < sizeof(connack)) {
+    ssize_t n = recv(fd, connack + got, sizeof(connack) - got, 0);
+    if (n <= 0) {
+      closeSocket();
+      return false;
+    }
+    got += n;
+  }
+  if (connack[0] != MQTT_CONNACK || connack[3] != 0) {
+    closeSocket();
+    return false;
+  }
+
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  rx.clear();
+  lastInbound = millis();
+  pingOutstanding = false;
+  return true;
+}
+
+bool PubSubClient::connected() {
+  return fd >= 0;
+}
+
+void PubSubClient::disconnect() {
+  if (fd >= 0) sendPacket(MQTT_DISCONNECT, {});
+  closeSocket();
+}
+
+void PubSubClient::closeSocket() {
+  if (fd >= 0) close(fd);
+  fd = -1;
+}
+
+// ============================================
+// PUBLISH / SUBSCRIBE
+// ============================================
+
+bool PubSubClient::publish(const char* topic, const char* payload) {
+  return publish(topic, payload, false);
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, bool retained) {
+  return publish(topic, (const uint8_t*)payload, payload ? strlen(payload) : 0, retained);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained) {
+  if (!connected()) return false;
+
+  std::vector<uint8_t> body;
+  appendString(body, topic);
+  body.insert(body.end(), payload, payload + length);
+  return sendPacket(MQTT_PUBLISH | (retained ? 1 : 0), body);
+}
+
+bool PubSubClient::subscribe(const char* topic) {
+  if (!connected()) return false;
+
+  std::vector<uint8_t> body;
+  body.push_back(nextPacketId >> 8);
+  body.push_back(nextPacketId & 0xff);
+  if (++nextPacketId == 0) nextPacketId = 1;
+  appendString(body, topic);
+  body.push_back(0);                  // QoS 0
+  return sendPacket(MQTT_SUBSCRIBE, body);
+}
+
+// ============================================
+// LOOP
+// ============================================
+
+bool PubSubClient::loop() {
+  if (!connected()) return false;
+
+  unsigned long now = millis();
+  if (pingOutstanding && now - lastInbound > MQTT_KEEPALIVE * 1500UL) {
+    closeSocket();
+    return false;
+  }
+  if (!pingOutstanding && now - lastOutbound >= MQTT_KEEPALIVE * 1000UL) {
+    if (!sendPacket(MQTT_PINGREQ, {})) return false;
+    pingOutstanding = true;
+  }
+
+  uint8_t chunk[1024];
+  for (;;) {
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+    if (n > 0) {
+      rx.insert(rx.end(), chunk, chunk + n);
+      lastInbound = now;
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    closeSocket();                    // broker closed or reset
+    return false;
+  }
+
+  // Complete packets: header, 1-4 byte remaining length, body
+  size_t pos = 0;
+  while (pos + 2 <= rx.size()) {
+    size_t length = 0;
+    size_t i = pos + 1;
+    int shift = 0;
+    bool complete = false;
+    while (i < rx.size() && shift <= 21) {
+      length |= (size_t)(rx[i] & 0x7f) << shift;
+      shift += 7;
+      if ((rx[i++] & 0x80) == 0) {
+        complete = true;
+        break;
+      }
+    }
+    if (!complete || i + length > rx.size()) break;
+
+    dispatch(rx[pos], rx.data() + i, length);
+    if (!connected()) return false;   // callback may disconnect
+    pos = i + length;
+  }
+  rx.erase(rx.begin(), rx.begin() + pos);
+  return true;
+}
+
+void PubSubClient::dispatch(uint8_t header, uint8_t* body, size_t length) {
+  if ((header & 0xf0) == MQTT_PINGRESP) {
+    pingOutstanding = false;
+    return;
+  }
+  if ((header & 0xf0) != MQTT_PUBLISH || length < 2) return;
+
+  size_t topicLength = (body[0] << 8) | body[1];
+  size_t offset = 2 + topicLength;
+  if ((header & 0x06) != 0) offset += 2;    // packet id on QoS > 0
+  if (offset > length || !callback) return;
+
+  // Like the real client: the topic is NUL-terminated in place by
+  // shifting it over the length prefix
+  memmove(body, body + 2, topicLength);
+  body[topicLength] = '\0';
+  callback((char*)body, body + offset, length - offset);
+}
+
+// ============================================
+// WIRE
+// ============================================
+
+void PubSubClient::appendString(std::vector<uint8_t>& body, const char* text) {
+  size_t length = strlen(text);
+  body.push_back(length >> 8);
+  body.push_back(length & 0xff);
+  body.insert(body.end(), text, text + length);
+}
+
+bool PubSubClient::sendPacket(uint8_t header, const std::vector<uint8_t>& body) {
+  uint8_t fixed[5];
+  size_t n = 0;
+  fixed[n++] = header;
+  size_t length = body.size();
+  do {
+    uint8_t digit = length & 0x7f;
+    length >>= 7;
+    fixed[n++] = digit | (length > 0 ? 0x80 : 0);
+  } while (length > 0 && n < sizeof(fixed));
+
+  if (!writeAll(fixed, n) || !writeAll(body.data(), body.size())) {
+    closeSocket();
+    return false;
+  }
+  lastOutbound = millis();
+  return true;
+}
+
+// Non-blocking socket: wait for room rather than drop part of a packet
+bool PubSubClient::writeAll(const uint8_t* data, size_t length) {
+  while (length > 0) {
+    ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+    if (n > 0) {
+      data += n;
+      length -= n;
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      struct pollfd p = { fd, POLLOUT, 0 };
+      if (poll(&p, 1, MQTT_SOCKET_TIMEOUT * 1000) > 0) continue;
+    }
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,58 @@
+// PubSubClient.h (host fleet)
+// MQTT 3.1.1 over a POSIX socket with the PubSubClient calls the
+// FleetSimulator and DeadbandPublisher use. QoS 0 only, like the
+// firmware. The WiFiClient argument is accepted and ignored.
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include "WiFiClient.h"
+
+#define MQTT_KEEPALIVE       15     // s, PubSubClient default
+#define MQTT_SOCKET_TIMEOUT  15     // s, connect + CONNACK
+
+class PubSubClient {
+public:
+  typedef std::function<void(char*, uint8_t*, unsigned int)> Callback;
+
+  PubSubClient();
+  PubSubClient(WiFiClient& client);
+  ~PubSubClient();
+
+  PubSubClient& setServer(const char* host, uint16_t port);
+  PubSubClient& setCallback(Callback callback);
+
+  bool connect(const char* id);
+  bool connected();
+  void disconnect();
+
+  bool publish(const char* topic, const char* payload);
+  bool publish(const char* topic, const char* payload, bool retained);
+  bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained = false);
+  bool subscribe(const char* topic);
+
+  // Sends keep-alives and dispatches received PUBLISH packets
+  bool loop();
+
+private:
+  const char* host;
+  uint16_t port;
+  Callback callback;
+  int fd;
+  uint16_t nextPacketId;
+  unsigned long lastOutbound;
+  unsigned long lastInbound;
+  bool pingOutstanding;
+  std::vector<uint8_t> rx;
+
+  bool sendPacket(uint8_t header, const std::vector<uint8_t>& body);
+  bool writeAll(const uint8_t* data, size_t length);
+  void dispatch(uint8_t header, uint8_t* body, size_t length);
+  void closeSocket();
+
+  static void appendString(std::vector<uint8_t>& body, const char* text);
+};
+
+#endif
@@ -0,0 +1,26 @@
+// WiFi.h (host fleet) - the PC's network is always up
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+
+#define WIFI_STA 1
+
+enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 };
+
+class IPAddress {
+public:
+  String toString() const { return "127.0.0.1"; }
+};
+
+class WiFiClass {
+public:
+  void mode(int) {}
+  void begin(const char*, const char*) {}
+  int status() { return WL_CONNECTED; }
+  IPAddress localIP() { return IPAddress(); }
+};
+
+extern WiFiClass WiFi;
+
+#endif
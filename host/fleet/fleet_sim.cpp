@@ -0,0 +1,94 @@
+// fleet_sim.cpp
+// Runs the firmware's FleetSimulator on a PC: hundreds of virtual
+// garages, each with its own MQTT session, publishing SensorData
+// through the same DeadbandPublisher as the board.
+//
+//   fleet_sim [--broker localhost] [--port 1883] [--garages N] [--seconds S]
+//             [--churn-ms MS]
+//
+// Start a local broker first (mosquitto -p 1883). The public
+// MQTT_SERVER is refused. Reports go to stdout and "sim/report".
+#include <Arduino.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "FleetSimulator.h"
+
+static FleetSimulator fleet;
+static volatile sig_atomic_t stopping = 0;
+
+static void onSignal(int) {
+  stopping = 1;
+}
+
+static void usage(const char* name) {
+  fprintf(stderr, "usage: %s [--broker host] [--port n] [--garages 1..%d] [--seconds s]\n"
+                  "       [--churn-ms ms (default %d, 0 = no forced reconnects)]\n",
+          name, FLEET_SIM_GARAGES, FLEET_SIM_CHURN_INTERVAL);
+}
+
+// One socket per garage plus the operator session
+static bool raiseFileLimit(int garages) {
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return false;
+
+  rlim_t needed = garages + 32;
+  if (limit.rlim_cur >= needed) return true;
+  if (limit.rlim_max < needed) return false;
+  limit.rlim_cur = needed;
+  return setrlimit(RLIMIT_NOFILE, &limit) == 0;
+}
+
+int main(int argc, char** argv) {
+  const char* broker = FLEET_SIM_BROKER;
+  int port = FLEET_SIM_PORT;
+  int garages = FLEET_SIM_GARAGES;
+  unsigned long seconds = 0;
+  unsigned long churnMs = FLEET_SIM_CHURN_INTERVAL;
+
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--broker") == 0 && hasValue) {
+      broker = argv[++i];
+    } else if (strcmp(argv[i], "--port") == 0 && hasValue) {
+      port = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--garages") == 0 && hasValue) {
+      garages = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--seconds") == 0 && hasValue) {
+      seconds = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--churn-ms") == 0 && hasValue) {
+      churnMs = strtoul(argv[++i], nullptr, 10);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (garages < 1 || garages > FLEET_SIM_GARAGES || port <= 0 || port > 65535) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (!raiseFileLimit(garages)) {
+    fprintf(stderr, "fleet_sim: not enough file descriptors for %d garages (ulimit -n)\n", garages);
+    return 2;
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  srand(time(nullptr));
+
+  logger.begin();
+  bool started = fleet.begin(broker, port, garages);
+  fleet.setChurnInterval(churnMs);
+  logger.drain();
+  if (!started) return 1;
+
+  while (!stopping && (seconds == 0 || millis() < seconds * 1000)) {
+    fleet.loop();
+    logger.drain();
+    delay(2);
+  }
+
+  logger.drain();
+  return 0;
+}
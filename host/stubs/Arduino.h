@@ -0,0 +1,164 @@
+// Arduino.h (host)
+// Just enough of the arduino-esp32 core to compile the firmware's
+// formatting and evaluation code on a PC. String follows the core's
+// semantics for the members the firmware uses.
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+#define PROGMEM
+#define IRAM_ATTR
+
+using std::min;
+using std::max;
+
+// ============================================
+// TIME / GPIO
+// ============================================
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return LOW; }
+inline int analogRead(int) { return 0; }
+inline unsigned long pulseIn(int, int, unsigned long = 1000000) { return 0; }
+inline long random(long max) { return max > 0 ? rand() % max : 0; }
+inline long random(long min, long max) { return min < max ? min + random(max - min) : min; }
+#define constrain(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+
+size_t strlcpy(char* dst, const char* src, size_t size);
+char* dtostrf(double value, signed char width, unsigned char decimals, char* out);
+
+// ============================================
+// STRING
+// ============================================
+class String {
+private:
+  std::string s;
+
+public:
+  String(const char* text = "") : s(text ? text : "") {}
+  String(const std::string& text) : s(text) {}
+  explicit String(char c) : s(1, c) {}
+  String(int value, unsigned char base = DEC) { setNumber(value, base); }
+  String(unsigned int value, unsigned char base = DEC) { setNumber(value, base); }
+  String(long value, unsigned char base = DEC) { setNumber(value, base); }
+  String(unsigned long value, unsigned char base = DEC) { setNumber((long long)value, base); }
+  String(float value, unsigned int decimals = 2) { setFloat(value, decimals); }
+  String(double value, unsigned int decimals = 2) { setFloat(value, decimals); }
+
+  unsigned int length() const { return s.size(); }
+  const char* c_str() const { return s.c_str(); }
+  char charAt(unsigned int i) const { return i < s.size() ? s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  bool reserve(unsigned int size) { s.reserve(size); return true; }
+
+  String& operator+=(const String& other) { s += other.s; return *this; }
+  String& operator+=(const char* other) { s += other ? other : ""; return *this; }
+  String& operator+=(char c) { s += c; return *this; }
+  String& operator+=(int value) { return *this += String(value); }
+  String& operator+=(unsigned int value) { return *this += String(value); }
+  String& operator+=(long value) { return *this += String(value); }
+  String& operator+=(unsigned long value) { return *this += String(value); }
+  bool concat(const String& other) { s += other.s; return true; }
+  bool concat(const char* other) { s += other ? other : ""; return true; }
+  bool concat(char c) { s += c; return true; }
+
+  bool operator==(const String& other) const { return s == other.s; }
+  bool operator==(const char* other) const { return s == (other ? other : ""); }
+  bool operator!=(const String& other) const { return s != other.s; }
+  bool operator!=(const char* other) const { return !(*this == other); }
+
+  int indexOf(char c, unsigned int from = 0) const { return find(s.find(c, from)); }
+  int indexOf(const char* text, unsigned int from = 0) const { return find(s.find(text, from)); }
+  int indexOf(const String& text, unsigned int from = 0) const { return find(s.find(text.s, from)); }
+  int lastIndexOf(char c) const { return find(s.rfind(c)); }
+  bool startsWith(const char* prefix) const { return s.rfind(prefix, 0) == 0; }
+  bool endsWith(const char* suffix) const {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+  }
+  String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    return from < s.size() ? String(s.substr(from, to - from)) : String();
+  }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return atof(s.c_str()); }
+  void trim() {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    size_t b = s.find_last_not_of(" \t\r\n");
+    s = (a == std::string::npos) ? "" : s.substr(a, b - a + 1);
+  }
+  void toUpperCase() { for (char& c : s) c = toupper((unsigned char)c); }
+  void toLowerCase() { for (char& c : s) c = tolower((unsigned char)c); }
+  bool isEmpty() const { return s.empty(); }
+
+  friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+  friend String operator+(const String& a, const char* b) { return String(a.s + (b ? b : "")); }
+  friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.s); }
+  friend String operator+(const String& a, char b) { return String(a.s + b); }
+
+private:
+  static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+  void setNumber(long long value, unsigned char base) {
+    char buf[34];
+    if (base == HEX) snprintf(buf, sizeof(buf), "%llx", (unsigned long long)value);
+    else snprintf(buf, sizeof(buf), "%lld", value);
+    s = buf;
+  }
+  void setFloat(double value, unsigned int decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+    s = buf;
+  }
+};
+
+// ============================================
+// SERIAL / ESP
+// ============================================
+class Print {
+public:
+  size_t print(const char* text) { return fputs(text, stdout) < 0 ? 0 : strlen(text); }
+  size_t print(const String& text) { return print(text.c_str()); }
+  size_t println(const char* text = "") { size_t n = print(text); putchar('\n'); return n + 1; }
+  size_t println(const String& text) { return println(text.c_str()); }
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long) {}
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+  uint32_t getFreeHeap() { return 0; }    // heap deltas are not meaningful on the host
+};
+
+extern EspClass ESP;
+
+#endif
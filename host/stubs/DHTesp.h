@@ -0,0 +1,19 @@
+// DHTesp.h (host)
+#ifndef HOST_DHTESP_H
+#define HOST_DHTESP_H
+
+#include <math.h>
+
+struct TempAndHumidity {
+  float temperature;
+  float humidity;
+};
+
+class DHTesp {
+public:
+  enum DHT_MODEL_t { DHT22 };
+  void setup(int, DHT_MODEL_t) {}
+  TempAndHumidity getTempAndHumidity() { return { NAN, NAN }; }
+};
+
+#endif
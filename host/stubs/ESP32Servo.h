@@ -0,0 +1,14 @@
+// ESP32Servo.h (host)
+#ifndef HOST_ESP32_SERVO_H
+#define HOST_ESP32_SERVO_H
+
+class Servo {
+public:
+  int attach(int) { return 0; }
+  void write(int value) { angle = value; }
+  int read() { return angle; }
+private:
+  int angle = 0;
+};
+
+#endif
@@ -0,0 +1,22 @@
+// HTTPClient.h (host) - every request fails with a connection error
+#ifndef HOST_HTTP_CLIENT_H
+#define HOST_HTTP_CLIENT_H
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+class HTTPClient {
+public:
+  bool begin(const String&) { return true; }
+  bool begin(WiFiClient&, const String&) { return true; }
+  void setReuse(bool) {}
+  void setTimeout(uint16_t) {}
+  void addHeader(const String&, const String&) {}
+  int GET() { return -1; }
+  int POST(uint8_t*, size_t) { return -1; }
+  int POST(const String&) { return -1; }
+  String getString() { return ""; }
+  void end() {}
+};
+
+#endif
@@ -0,0 +1,17 @@
+// Preferences.h (host) - no NVS, every key reads back its default
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+  bool begin(const char*, bool = false) { return true; }
+  void end() {}
+  uint32_t getUInt(const char*, uint32_t value = 0) { return value; }
+  size_t putUInt(const char*, uint32_t) { return 4; }
+  float getFloat(const char*, float value = 0) { return value; }
+  size_t putFloat(const char*, float) { return 4; }
+};
+
+#endif
@@ -0,0 +1,20 @@
+// PubSubClient.h (host) - offline client, like the firmware's before connect()
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+class PubSubClient {
+public:
+  PubSubClient() {}
+  PubSubClient(WiFiClient&) {}
+  bool connected() { return false; }
+  bool publish(const char*, const char* payload) { return publish(nullptr, payload, false); }
+  bool publish(const char*, const char* payload, bool) {
+    // The real client measures the payload before its connected() check
+    return payload != nullptr && strnlen(payload, 512) > 0 && connected();
+  }
+};
+
+#endif
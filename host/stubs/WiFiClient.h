@@ -0,0 +1,15 @@
+// WiFiClient.h (host)
+#ifndef HOST_WIFI_CLIENT_H
+#define HOST_WIFI_CLIENT_H
+
+#include <Arduino.h>
+
+class WiFiClient {
+public:
+  virtual ~WiFiClient() {}
+  virtual int connect(const char*, uint16_t) { return 0; }
+  virtual bool connected() { return false; }
+  virtual void stop() {}
+};
+
+#endif
@@ -0,0 +1,26 @@
+// WiFiClientSecure.h (host)
+#ifndef HOST_WIFI_CLIENT_SECURE_H
+#define HOST_WIFI_CLIENT_SECURE_H
+
+#include <memory>
+#include "WiFiClient.h"
+#include "mbedtls/ssl.h"
+
+struct sslclient_context {
+  int socket;
+  mbedtls_ssl_context ssl_ctx;
+};
+
+class WiFiClientSecure : public WiFiClient {
+protected:
+  std::shared_ptr<sslclient_context> sslclient = std::make_shared<sslclient_context>();
+
+public:
+  void setCACert(const char*) {}
+  void setInsecure() {}
+  void setHandshakeTimeout(unsigned long) {}
+  void setPlainStart() {}
+  int startTLS() { return 0; }
+};
+
+#endif
@@ -0,0 +1,15 @@
+// freertos/task.h (host)
+// No scheduler: tasks are not started, so the logger never drains on
+// its own. Host tools that want the log call logger.drain().
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+inline BaseType_t xTaskCreate(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*) {
+  return 0;
+}
+
+inline void vTaskDelay(TickType_t) {}
+
+#endif
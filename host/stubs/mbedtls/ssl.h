@@ -0,0 +1,25 @@
+// mbedtls/ssl.h (host) - sessions are never available
+#ifndef HOST_STUB_MBEDTLS_SSL_H
+#define HOST_STUB_MBEDTLS_SSL_H
+
+#include <stddef.h>
+#include <string.h>
+
+#define MBEDTLS_PRIVATE(member) member
+#define MBEDTLS_ERR_SSL_BAD_INPUT_DATA -0x7100
+
+struct mbedtls_ssl_context {
+  int unused;
+};
+
+struct mbedtls_ssl_session {
+  unsigned char id[32];
+  size_t id_len;
+};
+
+inline void mbedtls_ssl_session_init(mbedtls_ssl_session* session) { memset(session, 0, sizeof(*session)); }
+inline void mbedtls_ssl_session_free(mbedtls_ssl_session* session) {}
+inline int mbedtls_ssl_get_session(const mbedtls_ssl_context*, mbedtls_ssl_session*) { return MBEDTLS_ERR_SSL_BAD_INPUT_DATA; }
+inline int mbedtls_ssl_set_session(mbedtls_ssl_context*, const mbedtls_ssl_session*) { return MBEDTLS_ERR_SSL_BAD_INPUT_DATA; }
+
+#endif
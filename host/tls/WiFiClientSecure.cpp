@@ -0,0 +1,146 @@
+// WiFiClientSecure.cpp (host tls)
+#include "WiFiClientSecure.h"
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define TLS_SOCKET_TIMEOUT 10   // s, connect + handshake
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+WiFiClientSecure::WiFiClientSecure() {
+  sslclient = std::make_shared<sslclient_context>();
+  sslclient->socket = -1;
+  sslclient->ssl_ctx.ssl = nullptr;
+  tlsContext = SSL_CTX_new(TLS_client_method());
+  SSL_CTX_set_max_proto_version(tlsContext, TLS1_2_VERSION);
+  SSL_CTX_set_verify(tlsContext, SSL_VERIFY_NONE, nullptr);
+  stillInPlainStart = false;
+}
+
+WiFiClientSecure::~WiFiClientSecure() {
+  stop();
+  SSL_CTX_free(tlsContext);
+}
+
+// ============================================
+// CONNECTION
+// ============================================
+
+int WiFiClientSecure::connect(const char* host, uint16_t port) {
+  stop();
+
+  char service[8];
+  snprintf(service, sizeof(service), "%u", port);
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* addrs = nullptr;
+  if (getaddrinfo(host, service, &hints, &addrs) != 0) return 0;
+
+  int fd = -1;
+  for (struct addrinfo* a = addrs; a != nullptr && fd < 0; a = a->ai_next) {
+    fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+    if (fd < 0) continue;
+    if (::connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(addrs);
+  if (fd < 0) return 0;
+
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  struct timeval timeout = { TLS_SOCKET_TIMEOUT, 0 };
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  // The core's start_ssl_client(): socket, then mbedtls_ssl_setup()
+  SSL* ssl = SSL_new(tlsContext);
+  SSL_set_fd(ssl, fd);
+  SSL_set_tlsext_host_name(ssl, host);
+  sslclient->socket = fd;
+  sslclient->ssl_ctx.ssl = ssl;
+
+  if (stillInPlainStart) return 1;
+  return startTLS();
+}
+
+int WiFiClientSecure::startTLS() {
+  SSL* ssl = sslclient->ssl_ctx.ssl;
+  if (ssl == nullptr) return 0;
+  if (SSL_connect(ssl) != 1) {
+    stop();
+    return 0;
+  }
+  stillInPlainStart = false;
+  return 1;
+}
+
+bool WiFiClientSecure::connected() {
+  return sslclient->ssl_ctx.ssl != nullptr && !stillInPlainStart;
+}
+
+void WiFiClientSecure::stop() {
+  SSL* ssl = sslclient->ssl_ctx.ssl;
+  if (ssl != nullptr) {
+    // close_notify first: OpenSSL will not resume a session whose
+    // connection was dropped without one
+    if (SSL_is_init_finished(ssl)) SSL_shutdown(ssl);
+    SSL_free(ssl);
+  }
+  if (sslclient->socket >= 0) close(sslclient->socket);
+  sslclient->ssl_ctx.ssl = nullptr;
+  sslclient->socket = -1;
+}
+
+// ============================================
+// DATA
+// ============================================
+
+size_t WiFiClientSecure::write(const uint8_t* data, size_t length) {
+  if (!connected()) return 0;
+  size_t written = 0;
+  return SSL_write_ex(sslclient->ssl_ctx.ssl, data, length, &written) == 1 ? written : 0;
+}
+
+int WiFiClientSecure::read(uint8_t* data, size_t length) {
+  if (!connected()) return -1;
+  size_t got = 0;
+  return SSL_read_ex(sslclient->ssl_ctx.ssl, data, length, &got) == 1 ? (int)got : -1;
+}
+
+// ============================================
+// MBEDTLS SESSION CALLS
+// ============================================
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session* session) {
+  memset(session, 0, sizeof(*session));
+}
+
+void mbedtls_ssl_session_free(mbedtls_ssl_session* session) {
+  if (session->handle != nullptr) SSL_SESSION_free(session->handle);
+  memset(session, 0, sizeof(*session));
+}
+
+int mbedtls_ssl_get_session(const mbedtls_ssl_context* ssl, mbedtls_ssl_session* session) {
+  if (ssl->ssl == nullptr || session->handle != nullptr) return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+  session->handle = SSL_get1_session(ssl->ssl);
+  if (session->handle == nullptr) return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+
+  unsigned int length = 0;
+  const unsigned char* id = SSL_SESSION_get_id(session->handle, &length);
+  session->id_len = std::min<size_t>(length, sizeof(session->id));
+  memcpy(session->id, id, session->id_len);
+  return 0;
+}
+
+int mbedtls_ssl_set_session(mbedtls_ssl_context* ssl, const mbedtls_ssl_session* session) {
+  if (ssl->ssl == nullptr || session->handle == nullptr) return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+  return SSL_set_session(ssl->ssl, session->handle) == 1 ? 0 : MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+}
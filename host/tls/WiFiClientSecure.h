@@ -0,0 +1,44 @@
+// WiFiClientSecure.h (host tls)
+// TLS over a POSIX socket with OpenSSL, mirroring the parts of the
+// ESP32 core 3.x client ResumableTlsClient builds on: the protected
+// sslclient context, setPlainStart() / startTLS(). Capped at TLS 1.2
+// like the board's mbedTLS. Certificates are not verified.
+#ifndef HOST_TLS_WIFI_CLIENT_SECURE_H
+#define HOST_TLS_WIFI_CLIENT_SECURE_H
+
+#include <memory>
+#include "WiFiClient.h"
+#include "mbedtls/ssl.h"
+
+struct sslclient_context {
+  int socket;
+  mbedtls_ssl_context ssl_ctx;
+};
+
+class WiFiClientSecure : public WiFiClient {
+protected:
+  std::shared_ptr<sslclient_context> sslclient;
+  SSL_CTX* tlsContext;
+  bool stillInPlainStart;
+
+public:
+  WiFiClientSecure();
+  ~WiFiClientSecure();
+
+  void setCACert(const char*) {}
+  void setInsecure() {}
+  void setHandshakeTimeout(unsigned long) {}
+
+  // connect() stops after the TCP connect, startTLS() handshakes
+  void setPlainStart() { stillInPlainStart = true; }
+  int startTLS();
+
+  int connect(const char* host, uint16_t port) override;
+  bool connected() override;
+  void stop() override;
+
+  size_t write(const uint8_t* data, size_t length);
+  int read(uint8_t* data, size_t length);
+};
+
+#endif
@@ -0,0 +1,29 @@
+// mbedtls/ssl.h (host tls)
+// The session calls ResumableTlsClient makes, mapped onto OpenSSL: a
+// session is an SSL_SESSION plus a copy of its ID, like the fields the
+// firmware reads from mbedtls_ssl_session.
+#ifndef HOST_MBEDTLS_SSL_H
+#define HOST_MBEDTLS_SSL_H
+
+#include <stddef.h>
+#include <openssl/ssl.h>
+
+#define MBEDTLS_PRIVATE(member) member
+#define MBEDTLS_ERR_SSL_BAD_INPUT_DATA -0x7100
+
+struct mbedtls_ssl_context {
+  SSL* ssl;
+};
+
+struct mbedtls_ssl_session {
+  SSL_SESSION* handle;
+  unsigned char id[32];
+  size_t id_len;
+};
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session* session);
+void mbedtls_ssl_session_free(mbedtls_ssl_session* session);
+int mbedtls_ssl_get_session(const mbedtls_ssl_context* ssl, mbedtls_ssl_session* session);
+int mbedtls_ssl_set_session(mbedtls_ssl_context* ssl, const mbedtls_ssl_session* session);
+
+#endif
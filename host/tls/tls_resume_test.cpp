@@ -0,0 +1,172 @@
+// tls_resume_test.cpp
+// Runs the firmware's ResumableTlsClient against a local
+// `openssl s_server`, the same stand-in config.h suggests for the
+// Pushsafer URL. The first connect must be a full handshake, later
+// ones must resume, and clearSession() must force a full one again.
+// Checked with session tickets and with server-side session IDs.
+//
+//   tls_resume_test --openssl /usr/bin/openssl --workdir DIR
+#include <Arduino.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ResumableTlsClient.h"
+
+#define RESUME_CONNECTS 3
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  printf("  %s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok) failures++;
+}
+
+// Port the kernel hands out for an ephemeral bind
+static int freePort() {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(addr);
+  int port = -1;
+  if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+      getsockname(fd, (struct sockaddr*)&addr, &length) == 0) {
+    port = ntohs(addr.sin_port);
+  }
+  close(fd);
+  return port;
+}
+
+static bool portOpen(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  bool open = connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+  close(fd);
+  return open;
+}
+
+// ============================================
+// S_SERVER
+// ============================================
+
+static pid_t startServer(const char* openssl, const String& dir, int port, const char* extra) {
+  String accept = String(port);
+  String cert = dir + "/tls_test_cert.pem";
+  String key = dir + "/tls_test_key.pem";
+
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    // Quiet: the readiness probe below shows up as a failed handshake
+    int devNull = open("/dev/null", O_RDWR);
+    dup2(devNull, STDIN_FILENO);
+    dup2(devNull, STDOUT_FILENO);
+    dup2(devNull, STDERR_FILENO);
+    const char* argv[] = { openssl, "s_server", "-accept", accept.c_str(),
+                           "-cert", cert.c_str(), "-key", key.c_str(), "-www",
+                           extra, nullptr };
+    execv(openssl, (char* const*)argv);
+    _exit(127);
+  }
+
+  for (int i = 0; i < 100 && pid > 0; i++) {
+    if (portOpen(port)) return pid;
+    delay(50);
+  }
+  if (pid > 0) kill(pid, SIGTERM);
+  return -1;
+}
+
+static void stopServer(pid_t pid) {
+  kill(pid, SIGTERM);
+  waitpid(pid, nullptr, 0);
+}
+
+// ============================================
+// CASES
+// ============================================
+
+static bool fetchStatusPage(ResumableTlsClient& client) {
+  const char request[] = "GET / HTTP/1.0\r\n\r\n";
+  if (client.write((const uint8_t*)request, sizeof(request) - 1) != sizeof(request) - 1) return false;
+  char reply[16] = {};
+  return client.read((uint8_t*)reply, sizeof(reply) - 1) > 0 && strncmp(reply, "HTTP/1.0 200", 12) == 0;
+}
+
+static void runCases(const char* openssl, const String& dir, const char* mode, const char* extra) {
+  printf("%s\n", mode);
+  int port = freePort();
+  pid_t server = startServer(openssl, dir, port, extra);
+  if (server < 0) {
+    check(false, "openssl s_server started");
+    return;
+  }
+
+  ResumableTlsClient client;
+  check(!client.hasSession(), "no session before the first connect");
+
+  bool ok = client.connect("localhost", port);
+  check(ok && !client.resumed(), "first connect: full handshake");
+  check(ok && fetchStatusPage(client), "HTTP request over the connection");
+  check(client.hasSession(), "session saved");
+  client.stop();
+
+  int hits = 0;
+  for (int i = 0; i < RESUME_CONNECTS; i++) {
+    if (client.connect("localhost", port) && client.resumed()) hits++;
+    client.stop();
+  }
+  check(hits == RESUME_CONNECTS, "later connects resume the session");
+
+  client.clearSession();
+  ok = client.connect("localhost", port);
+  check(ok && !client.resumed(), "after clearSession(): full handshake");
+  client.stop();
+  ok = client.connect("localhost", port);
+  check(ok && client.resumed(), "then resumes again");
+  client.stop();
+
+  stopServer(server);
+}
+
+int main(int argc, char** argv) {
+  const char* openssl = "/usr/bin/openssl";
+  String dir = ".";
+
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--openssl") == 0 && hasValue) {
+      openssl = argv[++i];
+    } else if (strcmp(argv[i], "--workdir") == 0 && hasValue) {
+      dir = argv[++i];
+    } else {
+      fprintf(stderr, "usage: %s [--openssl path] [--workdir dir]\n", argv[0]);
+      return 2;
+    }
+  }
+  signal(SIGPIPE, SIG_IGN);
+
+  String command = String(openssl) + " req -x509 -newkey ec -pkeyopt ec_paramgen_curve:P-256"
+                   " -nodes -days 1 -subj /CN=localhost -keyout " + dir + "/tls_test_key.pem"
+                   " -out " + dir + "/tls_test_cert.pem 2>/dev/null";
+  if (system(command.c_str()) != 0) {
+    fprintf(stderr, "tls_resume_test: could not create a test certificate with %s\n", openssl);
+    return 2;
+  }
+
+  runCases(openssl, dir, "session tickets", nullptr);
+  runCases(openssl, dir, "session IDs", "-no_ticket");
+
+  if (failures > 0) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON files from garage_bench.
+
+    bench_compare.py baseline.json current.json [--threshold 10]
+
+A case regresses when its CPU time grows by more than --threshold
+percent, or when it allocates more per operation than the baseline.
+Uses the median aggregate when the run had repetitions. Exits 1 if any
+case regressed, 2 if a file cannot be read.
+"""
+import argparse
+import json
+import sys
+
+UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    """name -> (cpu ns/op, allocs/op or None)"""
+    with open(path) as f:
+        runs = json.load(f)["benchmarks"]
+
+    results = {}
+    medians = set()
+    for run in runs:
+        name = run.get("run_name", run["name"])
+        if run.get("run_type") == "aggregate":
+            if run.get("aggregate_name") != "median":
+                continue
+            medians.add(name)
+        elif name in medians:
+            continue
+        ns = run["cpu_time"] * UNIT_NS[run.get("time_unit", "ns")]
+        results[name] = (ns, run.get("allocs_per_op"))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed slowdown in percent (default 10)")
+    args = parser.parse_args()
+
+    try:
+        baseline = load(args.baseline)
+        current = load(args.current)
+    except (OSError, ValueError, KeyError) as e:
+        print(f"bench_compare: {e}", file=sys.stderr)
+        return 2
+
+    regressions = 0
+    print(f"{'case':<32} {'baseline':>12} {'current':>12} {'change':>8}  allocs")
+    for name, (ns, allocs) in sorted(current.items()):
+        if name not in baseline:
+            print(f"{name:<32} {'-':>12} {ns:>10.1f}ns {'new':>8}")
+            continue
+
+        base_ns, base_allocs = baseline[name]
+        change = (ns - base_ns) / base_ns * 100 if base_ns > 0 else 0.0
+        slower = change > args.threshold
+        more_allocs = (allocs is not None and base_allocs is not None
+                       and allocs > base_allocs + 0.01)
+
+        alloc_text = "" if allocs is None else f"{allocs:.2f}"
+        if base_allocs is not None and allocs is not None and allocs != base_allocs:
+            alloc_text = f"{base_allocs:.2f} -> {allocs:.2f}"
+
+        flag = "  REGRESSION" if slower or more_allocs else ""
+        print(f"{name:<32} {base_ns:>10.1f}ns {ns:>10.1f}ns {change:>+7.1f}%  {alloc_text}{flag}")
+        regressions += slower or more_allocs
+
+    for name in sorted(set(baseline) - set(current)):
+        print(f"{name:<32} missing from current run")
+
+    if regressions:
+        print(f"\n{regressions} case(s) regressed (threshold {args.threshold:g}%)")
+        return 1
+    print(f"\nno regressions (threshold {args.threshold:g}%)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Collect garage/diag/latency breakdowns and report percentiles.
+
+    latency_collector.py --broker localhost [--port 1883] [--interval 60]
+    mosquitto_sub -h <broker> -t garage/diag/latency | latency_collector.py --stdin
+
+The device keeps only TRACE_SAMPLES totals per kind, so its own p99 is
+close to the max of a few dozen samples. This keeps every breakdown it
+receives and reports nearest-rank p50/p90/p99 per trace kind, for the
+total and for each hop (time since "received"). --broker needs
+paho-mqtt; --stdin reads one JSON object per line (a leading topic from
+mosquitto_sub -v is skipped). Prints a report every --interval seconds
+and once more at the end.
+"""
+import argparse
+import json
+import math
+import sys
+import time
+from collections import defaultdict
+
+TOPIC = "garage/diag/latency"
+PERCENTILES = (50, 90, 99)
+# LatencyTracer hop names, in pipeline order
+HOP_ORDER = ("accepted", "act_start", "act_done", "queued", "delivered")
+
+
+class Collector:
+    def __init__(self):
+        # kind -> series name ("total" or a hop) -> list of microseconds
+        self.samples = defaultdict(lambda: defaultdict(list))
+        self.ids = set()
+        self.rejected = 0
+
+    def add_line(self, line):
+        line = line.strip()
+        if not line:
+            return
+        brace = line.find("{")
+        if brace < 0:
+            self.rejected += 1
+            return
+        try:
+            trace = json.loads(line[brace:])
+            kind = trace["kind"]
+            total = int(trace["total_us"])
+            hops = trace.get("hops", {})
+        except (ValueError, KeyError, TypeError):
+            self.rejected += 1
+            return
+
+        # MQTT may redeliver; a trace counts once
+        key = (kind, trace.get("id"), trace.get("bay"), total)
+        if key in self.ids:
+            return
+        self.ids.add(key)
+
+        series = self.samples[kind]
+        series["total"].append(total)
+        for hop, us in hops.items():
+            series[hop].append(int(us))
+
+    def report(self, out=sys.stdout):
+        if not self.samples:
+            print("no latency samples yet", file=out)
+            return
+        header = f"{'kind':<12} {'series':<12} {'n':>6}" + "".join(
+            f" {'p%d ms' % p:>10}" for p in PERCENTILES) + f" {'max ms':>10}"
+        print(header, file=out)
+        for kind in sorted(self.samples):
+            series = self.samples[kind]
+            hops = sorted((n for n in series if n != "total"),
+                          key=lambda n: (HOP_ORDER.index(n) if n in HOP_ORDER else len(HOP_ORDER), n))
+            names = ["total"] + hops
+            for name in names:
+                values = sorted(series[name])
+                cells = "".join(f" {percentile(values, p) / 1000:>10.1f}" for p in PERCENTILES)
+                print(f"{kind:<12} {name:<12} {len(values):>6}{cells} {values[-1] / 1000:>10.1f}",
+                      file=out)
+        if self.rejected:
+            print(f"({self.rejected} malformed message(s) skipped)", file=out)
+        out.flush()
+
+
+def percentile(sorted_values, pct):
+    """Nearest-rank, same definition as LatencyTracer::percentile()."""
+    rank = max(1, math.ceil(pct * len(sorted_values) / 100))
+    return sorted_values[rank - 1]
+
+
+def run_stdin(collector, interval):
+    next_report = time.monotonic() + interval
+    for line in sys.stdin:
+        collector.add_line(line)
+        if interval > 0 and time.monotonic() >= next_report:
+            collector.report()
+            next_report = time.monotonic() + interval
+
+
+def run_broker(collector, args):
+    try:
+        import paho.mqtt.client as mqtt
+    except ImportError:
+        print("latency_collector: --broker needs paho-mqtt (pip install paho-mqtt); "
+              "or pipe mosquitto_sub into --stdin", file=sys.stderr)
+        return 2
+
+    def on_connect(client, userdata, flags, rc, *extra):
+        client.subscribe(args.topic)
+
+    def on_message(client, userdata, msg):
+        collector.add_line(msg.payload.decode("utf-8", "replace"))
+
+    try:
+        client = mqtt.Client(mqtt.CallbackAPIVersion.VERSION1)   # paho-mqtt >= 2
+    except AttributeError:
+        client = mqtt.Client()
+    client.on_connect = on_connect
+    client.on_message = on_message
+    try:
+        client.connect(args.broker, args.port)
+    except OSError as e:
+        print(f"latency_collector: {args.broker}:{args.port}: {e}", file=sys.stderr)
+        return 2
+
+    client.loop_start()
+    try:
+        while True:
+            time.sleep(args.interval if args.interval > 0 else 3600)
+            collector.report()
+    finally:
+        client.loop_stop()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--broker", help="MQTT broker to subscribe on")
+    source.add_argument("--stdin", action="store_true",
+                        help="read breakdowns from stdin (e.g. mosquitto_sub)")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--topic", default=TOPIC)
+    parser.add_argument("--interval", type=float, default=60.0,
+                        help="seconds between reports, 0 = only at the end (default 60)")
+    args = parser.parse_args()
+
+    collector = Collector()
+    status = 0
+    try:
+        if args.stdin:
+            run_stdin(collector, args.interval)
+        else:
+            status = run_broker(collector, args)
+    except KeyboardInterrupt:
+        pass
+
+    if status == 0:
+        collector.report()
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,229 @@
+// AlarmRules.cpp
+#include "AlarmRules.h"
+
+static_assert(RULE_MAX_RULES <= 32, "rule masks are 32 bits wide");
+static_assert(RULE_MAX_TERMS <= 8, "term latches are 8 bits wide");
+static_assert(RULE_MAX_AGGREGATES <= 255, "aggregate slots are indexed with uint8_t");
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+AlarmRuleEngine::AlarmRuleEngine() {
+  rules = nullptr;
+  ruleCount = 0;
+  handler = nullptr;
+  head = 0;
+  filled = 0;
+  slotCount = 0;
+  termCount = 0;
+  pendingMask = 0;
+  activeMask = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+// ============================================
+// COMPILE
+// ============================================
+
+bool AlarmRuleEngine::begin(const AlarmRule* table, uint8_t count, RuleHandler onChange) {
+  bool ok = true;
+  if (count > RULE_MAX_RULES) {
+    LOG_ERROR("❌ %u alarm rules, only %d fit", count, RULE_MAX_RULES);
+    count = RULE_MAX_RULES;
+    ok = false;
+  }
+
+  rules = table;
+  ruleCount = count;
+  handler = onChange;
+  head = 0;
+  filled = 0;
+  slotCount = 0;
+  termCount = 0;
+  pendingMask = 0;
+  activeMask = 0;
+  memset(termLatch, 0, sizeof(termLatch));
+  memset(fireCount, 0, sizeof(fireCount));
+  memset(&stats, 0, sizeof(stats));
+
+  for (uint8_t r = 0; r < ruleCount; r++) {
+    firstTerm[r] = termCount;
+    ruleTerms[r] = 0;
+
+    for (uint8_t t = 0; t < RULE_MAX_TERMS; t++) {
+      const RuleTerm& term = rules[r].terms[t];
+      if (term.window == 0) break;
+
+      CompiledTerm& ct = terms[termCount++];
+      ct.slot = compileSlot(term);
+      ct.compare = term.compare;
+      ct.enter = term.enter;
+      ct.exit = term.exit;
+      ruleTerms[r]++;
+    }
+
+    if (ruleTerms[r] == 0) {
+      LOG_ERROR("❌ Alarm rule '%s' has no terms", rules[r].name);
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+uint8_t AlarmRuleEngine::compileSlot(const RuleTerm& term) {
+  uint8_t window = (term.window > RULE_WINDOW_MAX) ? RULE_WINDOW_MAX : term.window;
+  if (term.aggregate == RULE_AGG_LAST) window = 1;
+
+  for (uint8_t s = 0; s < slotCount; s++) {
+    if (slots[s].input == term.input && slots[s].aggregate == term.aggregate &&
+        slots[s].window == window) {
+      return s;
+    }
+  }
+
+  RuleAggSlot& slot = slots[slotCount];
+  slot.input = term.input;
+  slot.aggregate = term.aggregate;
+  slot.window = window;
+  return slotCount++;
+}
+
+// ============================================
+// EVALUATE
+// ============================================
+
+// NaN samples (failed DHT reads) are skipped; an all-NaN window is NaN
+float AlarmRuleEngine::aggregate(const RuleAggSlot& slot) {
+  uint8_t n = (slot.window < filled) ? slot.window : filled;
+  const float* samples = history[slot.input];
+  float result = NAN;
+  uint8_t valid = 0;
+
+  for (uint8_t i = 0; i < n; i++) {
+    float v = samples[(head + RULE_WINDOW_MAX - 1 - i) % RULE_WINDOW_MAX];
+    if (isnan(v)) continue;
+
+    if (valid == 0) {
+      result = v;
+    } else if (slot.aggregate == RULE_AGG_MEAN) {
+      result += v;
+    } else if (slot.aggregate == RULE_AGG_MIN) {
+      if (v < result) result = v;
+    } else if (slot.aggregate == RULE_AGG_MAX) {
+      if (v > result) result = v;
+    }
+    valid++;
+  }
+
+  if (slot.aggregate == RULE_AGG_MEAN && valid > 1) result /= valid;
+  return result;
+}
+
+// Hysteresis: NaN compares false, so a missing value holds the latch
+bool AlarmRuleEngine::updateLatch(const CompiledTerm& term, bool latched) {
+  float v = slotValue[term.slot];
+
+  if (term.compare == RULE_ABOVE) {
+    return latched ? !(v < term.exit) : (v > term.enter);
+  }
+  return latched ? !(v > term.exit) : (v < term.enter);
+}
+
+void AlarmRuleEngine::evaluate(const float* inputs, unsigned long now) {
+  unsigned long start = micros();
+
+  for (uint8_t i = 0; i < RULE_IN_COUNT; i++) {
+    history[i][head] = inputs[i];
+  }
+  head = (head + 1) % RULE_WINDOW_MAX;
+  if (filled < RULE_WINDOW_MAX) filled++;
+
+  for (uint8_t s = 0; s < slotCount; s++) {
+    slotValue[s] = aggregate(slots[s]);
+  }
+
+  for (uint8_t r = 0; r < ruleCount; r++) {
+    uint8_t n = ruleTerms[r];
+    if (n == 0) continue;
+
+    uint8_t latch = termLatch[r];
+    for (uint8_t t = 0; t < n; t++) {
+      bool held = updateLatch(terms[firstTerm[r] + t], latch & (1 << t));
+      latch = held ? (latch | (1 << t)) : (latch & ~(1 << t));
+    }
+    termLatch[r] = latch;
+
+    bool match = (rules[r].join == RULE_ALL) ? (latch == (1 << n) - 1) : (latch != 0);
+    uint32_t bit = 1UL << r;
+
+    if (!match) {
+      pendingMask &= ~bit;
+      if (activeMask & bit) {
+        activeMask &= ~bit;
+        stats.cleared++;
+        if (handler) handler(rules[r], false);
+      }
+      continue;
+    }
+
+    if (!(pendingMask & bit)) {
+      pendingMask |= bit;
+      pendingSince[r] = now;
+    }
+
+    bool fire;
+    if (activeMask & bit) {
+      fire = rules[r].repeat > 0 && now - firedAt[r] >= rules[r].repeat;
+    } else {
+      fire = now - pendingSince[r] >= rules[r].minDuration;
+    }
+    if (!fire) continue;
+
+    activeMask |= bit;
+    firedAt[r] = now;
+    fireCount[r]++;
+    stats.fired++;
+    if (handler) handler(rules[r], true);
+  }
+
+  unsigned long elapsed = micros() - start;
+  stats.evaluations++;
+  stats.totalMicros += elapsed;
+  if (elapsed > stats.maxMicros) stats.maxMicros = elapsed;
+}
+
+// ============================================
+// UTILITIES
+// ============================================
+
+bool AlarmRuleEngine::isActive(uint8_t rule) {
+  return rule < ruleCount && (activeMask & (1UL << rule));
+}
+
+const RuleStats& AlarmRuleEngine::getStats() {
+  return stats;
+}
+
+void AlarmRuleEngine::printStats() {
+  LOG_INFO("[Rules] %u rules, %u terms, %u aggregates | evals=%lu avg=%luus max=%luus",
+           ruleCount, termCount, slotCount, stats.evaluations,
+           stats.evaluations ? stats.totalMicros / stats.evaluations : 0, stats.maxMicros);
+
+  for (uint8_t r = 0; r < ruleCount; r++) {
+    LOG_INFO("   %-12s fired=%lu %s", rules[r].name, fireCount[r],
+             isActive(r) ? "ACTIVE" : "");
+  }
+}
+
+const char* AlarmRuleEngine::inputName(RuleInput input) {
+  switch (input) {
+    case RULE_IN_TEMPERATURE:  return "temperature";
+    case RULE_IN_HUMIDITY:     return "humidity";
+    case RULE_IN_SMOKE:        return "smoke";
+    case RULE_IN_PIR:          return "pir";
+    case RULE_IN_DOORS_CLOSED: return "doorsClosed";
+    default:                   return "unknown";
+  }
+}
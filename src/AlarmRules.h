@@ -0,0 +1,93 @@
+// AlarmRules.h
+#ifndef ALARM_RULES_H
+#define ALARM_RULES_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "Logger.h"
+
+#define RULE_MAX_AGGREGATES     (RULE_MAX_RULES * RULE_MAX_TERMS)
+
+// Called on every fire (active = true, also for repeats) and on clear
+typedef void (*RuleHandler)(const AlarmRule& rule, bool active);
+
+// One windowed aggregate, shared by every term that asks for it
+struct RuleAggSlot {
+  RuleInput input;
+  RuleAggregate aggregate;
+  uint8_t window;
+};
+
+struct CompiledTerm {
+  uint8_t slot;           // index into the aggregate table
+  RuleCompare compare;
+  float enter;
+  float exit;
+};
+
+struct RuleStats {
+  unsigned long evaluations;
+  unsigned long totalMicros;
+  unsigned long maxMicros;
+  unsigned long fired;
+  unsigned long cleared;
+};
+
+// ============================================
+// CLASS ALARM RULE ENGINE
+// ============================================
+// begin() compiles the rule table: identical (input, aggregate, window)
+// triples are merged and terms are flattened into one array. evaluate()
+// then costs at most RULE_IN_COUNT pushes, one pass per distinct
+// aggregate (<= RULE_WINDOW_MAX samples) and one compare per term.
+class AlarmRuleEngine {
+private:
+  const AlarmRule* rules;
+  uint8_t ruleCount;
+  RuleHandler handler;
+
+  // Input history, one ring shared by all inputs
+  float history[RULE_IN_COUNT][RULE_WINDOW_MAX];
+  uint8_t head;
+  uint8_t filled;
+
+  // Compiled table
+  RuleAggSlot slots[RULE_MAX_AGGREGATES];
+  float slotValue[RULE_MAX_AGGREGATES];
+  uint8_t slotCount;
+  CompiledTerm terms[RULE_MAX_AGGREGATES];
+  uint8_t termCount;
+  uint8_t firstTerm[RULE_MAX_RULES];
+  uint8_t ruleTerms[RULE_MAX_RULES];
+
+  // Per-rule state
+  uint8_t termLatch[RULE_MAX_RULES];    // bit per term
+  uint32_t pendingMask;
+  uint32_t activeMask;
+  unsigned long pendingSince[RULE_MAX_RULES];
+  unsigned long firedAt[RULE_MAX_RULES];
+  unsigned long fireCount[RULE_MAX_RULES];
+
+  RuleStats stats;
+
+  uint8_t compileSlot(const RuleTerm& term);
+  float aggregate(const RuleAggSlot& slot);
+  bool updateLatch(const CompiledTerm& term, bool latched);
+
+public:
+  AlarmRuleEngine();
+
+  // Compile `count` rules; the table must outlive the engine
+  bool begin(const AlarmRule* table, uint8_t count, RuleHandler onChange);
+
+  // One sample: inputs[] is indexed by RuleInput
+  void evaluate(const float* inputs, unsigned long now);
+
+  bool isActive(uint8_t rule);
+  const RuleStats& getStats();
+  void printStats();
+
+  static const char* inputName(RuleInput input);
+};
+
+#endif
@@ -0,0 +1,257 @@
+// ApproachTracker.cpp
+#include "ApproachTracker.h"
+
+static_assert(APPROACH_RANGE_EXIT >= APPROACH_RANGE, "range exit must not be inside the entry range");
+static_assert(APPROACH_EXIT_SPEED <= APPROACH_ENTER_SPEED, "exit speed must not exceed the entry speed");
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+ApproachTracker::ApproachTracker() {
+  bayCount = 0;
+  hintMask = 0;
+  preOpenMask = 0;
+  waitMask = 0;
+  memset(&stats, 0, sizeof(stats));
+
+  for (uint8_t b = 0; b < BAY_MAX; b++) {
+    state[b] = APPROACH_NONE;
+    hintAt[b] = 0;
+    preOpenAt[b] = 0;
+    arrivedAt[b] = 0;
+    resetTrack(b);
+  }
+}
+
+void ApproachTracker::begin(uint8_t count) {
+  bayCount = (count > BAY_MAX) ? BAY_MAX : count;
+
+  LOG_INFO("  ✓Approach tracking%s", APPROACH_PREOPEN ? " (predictive opening ON)" : "");
+}
+
+void ApproachTracker::resetTrack(uint8_t bay) {
+  sampleHead[bay] = 0;
+  sampleCount[bay] = 0;
+  velocity[bay] = 0;
+  minDistance[bay] = MAX_DISTANCE;
+}
+
+// ============================================
+// SAMPLES
+// ============================================
+
+bool ApproachTracker::addSample(uint8_t bay, float distance, unsigned long now) {
+  if (bay >= bayCount) return false;
+
+  ApproachState previous = state[bay];
+
+  // An echo timeout reads MAX_DISTANCE: that is a missing sample, not a
+  // far target. An open track survives it until APPROACH_GAP has passed
+  // since the last real echo.
+  if (distance >= MAX_DISTANCE && sampleCount[bay] > 0) {
+    uint8_t last = (sampleHead[bay] + APPROACH_HISTORY - 1) % APPROACH_HISTORY;
+    if (now - sampleTime[bay][last] <= APPROACH_GAP) return false;
+  }
+
+  // Target out of range: close the track. An open track only closes
+  // past APPROACH_RANGE_EXIT.
+  float range = (sampleCount[bay] > 0) ? APPROACH_RANGE_EXIT : APPROACH_RANGE;
+  if (distance >= range) {
+    if (previous == APPROACH_NONE || previous == APPROACH_PASSING) {
+      state[bay] = APPROACH_NONE;
+    } else if (previous != APPROACH_DEPARTING &&
+               minDistance[bay] > VEHICLE_DETECT_DISTANCE) {
+      state[bay] = APPROACH_PASSING;
+      stats.passings++;
+    } else {
+      state[bay] = APPROACH_NONE;
+    }
+    resetTrack(bay);
+    return state[bay] != previous;
+  }
+
+  // Echo dropouts longer than APPROACH_GAP start a fresh track
+  if (sampleCount[bay] > 0) {
+    uint8_t last = (sampleHead[bay] + APPROACH_HISTORY - 1) % APPROACH_HISTORY;
+    if (now - sampleTime[bay][last] > APPROACH_GAP) resetTrack(bay);
+  }
+
+  uint8_t head = sampleHead[bay];
+  sampleDistance[bay][head] = distance;
+  sampleTime[bay][head] = now;
+  sampleHead[bay] = (head + 1) % APPROACH_HISTORY;
+  if (sampleCount[bay] < APPROACH_HISTORY) sampleCount[bay]++;
+  if (distance < minDistance[bay]) minDistance[bay] = distance;
+
+  if (sampleCount[bay] < APPROACH_MIN_SAMPLES) {
+    if (previous == APPROACH_PASSING) state[bay] = APPROACH_NONE;
+    return state[bay] != previous;
+  }
+
+  fit(bay);
+
+  // Moving states are entered at APPROACH_ENTER_SPEED and kept down to
+  // APPROACH_EXIT_SPEED
+  float v = velocity[bay];
+  if (v <= -APPROACH_ENTER_SPEED || (previous == APPROACH_APPROACHING && v < -APPROACH_EXIT_SPEED)) {
+    state[bay] = APPROACH_APPROACHING;
+  } else if (v >= APPROACH_ENTER_SPEED || (previous == APPROACH_DEPARTING && v > APPROACH_EXIT_SPEED)) {
+    state[bay] = APPROACH_DEPARTING;
+  } else {
+    state[bay] = APPROACH_STATIONARY;
+  }
+
+  if (state[bay] == APPROACH_APPROACHING && previous != APPROACH_APPROACHING) {
+    stats.approaches++;
+  }
+  return state[bay] != previous;
+}
+
+// Least-squares slope of distance over time (cm/s)
+void ApproachTracker::fit(uint8_t bay) {
+  uint8_t n = sampleCount[bay];
+  uint8_t oldest = (sampleHead[bay] + APPROACH_HISTORY - n) % APPROACH_HISTORY;
+  unsigned long t0 = sampleTime[bay][oldest];
+
+  float sumT = 0, sumD = 0, sumTT = 0, sumTD = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t idx = (oldest + i) % APPROACH_HISTORY;
+    float t = (sampleTime[bay][idx] - t0) / 1000.0;
+    float d = sampleDistance[bay][idx];
+    sumT += t;
+    sumD += d;
+    sumTT += t * t;
+    sumTD += t * d;
+  }
+
+  float denom = n * sumTT - sumT * sumT;
+  velocity[bay] = (denom > 1e-6) ? (n * sumTD - sumT * sumD) / denom : 0;
+}
+
+// ============================================
+// ACCESSORS
+// ============================================
+
+ApproachState ApproachTracker::getState(uint8_t bay) {
+  return (bay < bayCount) ? state[bay] : APPROACH_NONE;
+}
+
+float ApproachTracker::getVelocity(uint8_t bay) {
+  return (bay < bayCount) ? velocity[bay] : 0;
+}
+
+long ApproachTracker::getEtaMs(uint8_t bay) {
+  if (bay >= bayCount || state[bay] != APPROACH_APPROACHING) return -1;
+
+  uint8_t last = (sampleHead[bay] + APPROACH_HISTORY - 1) % APPROACH_HISTORY;
+  float remaining = sampleDistance[bay][last] - VEHICLE_DETECT_DISTANCE;
+  if (remaining <= 0) return 0;
+
+  return (long)(remaining / -velocity[bay] * 1000.0);
+}
+
+// ============================================
+// PREDICTIVE OPENING
+// ============================================
+
+void ApproachTracker::hint(uint8_t bay, unsigned long now) {
+  if (bay >= bayCount) return;
+  hintMask |= 1 << bay;
+  hintAt[bay] = now;
+}
+
+bool ApproachTracker::shouldPreOpen(uint8_t bay, unsigned long now) {
+  if (!APPROACH_PREOPEN || bay >= bayCount) return false;
+
+  uint8_t bit = 1 << bay;
+  if (!(hintMask & bit) || (preOpenMask & bit)) return false;
+
+  if (now - hintAt[bay] > APPROACH_HINT_WINDOW) {
+    hintMask &= ~bit;   // stale hint
+    return false;
+  }
+
+  long eta = getEtaMs(bay);
+  return eta >= 0 && eta <= APPROACH_PREOPEN_LEAD;
+}
+
+void ApproachTracker::onPreOpen(uint8_t bay, unsigned long now) {
+  uint8_t bit = 1 << bay;
+  hintMask &= ~bit;     // one hint authorises one opening
+  preOpenMask |= bit;
+  preOpenAt[bay] = now;
+  stats.preOpens++;
+}
+
+bool ApproachTracker::preOpenExpired(uint8_t bay, unsigned long now) {
+  uint8_t bit = 1 << bay;
+  if (!(preOpenMask & bit)) return false;
+  if (now - preOpenAt[bay] <= APPROACH_PREOPEN_TIMEOUT) return false;
+
+  preOpenMask &= ~bit;
+  stats.falsePreOpens++;
+  return true;
+}
+
+// ============================================
+// DRIVER WAIT METRICS
+// ============================================
+
+void ApproachTracker::onArrival(uint8_t bay, unsigned long now, bool doorOpen) {
+  if (bay >= bayCount) return;
+
+  uint8_t bit = 1 << bay;
+  preOpenMask &= ~bit;    // pre-open confirmed
+  stats.arrivals++;
+
+  if (doorOpen) {
+    stats.waitCount++;    // zero wait
+    return;
+  }
+  waitMask |= bit;
+  arrivedAt[bay] = now;
+}
+
+void ApproachTracker::onDeparture(uint8_t bay) {
+  uint8_t bit = 1 << bay;
+  if (waitMask & bit) stats.abandoned++;
+  waitMask &= ~bit;
+}
+
+void ApproachTracker::onDoorOpened(uint8_t bay, unsigned long now) {
+  uint8_t bit = 1 << bay;
+  if (!(waitMask & bit)) return;
+  waitMask &= ~bit;
+
+  unsigned long wait = now - arrivedAt[bay];
+  stats.waitCount++;
+  stats.totalWait += wait;
+  if (wait > stats.maxWait) stats.maxWait = wait;
+}
+
+// ============================================
+// UTILITIES
+// ============================================
+
+const ApproachStats& ApproachTracker::getStats() {
+  return stats;
+}
+
+void ApproachTracker::printStats() {
+  LOG_INFO("[Approach] approaches=%lu passings=%lu preOpens=%lu false=%lu",
+           stats.approaches, stats.passings, stats.preOpens, stats.falsePreOpens);
+  LOG_INFO("   Driver wait: arrivals=%lu avg=%lums max=%lums abandoned=%lu",
+           stats.arrivals, stats.waitCount ? stats.totalWait / stats.waitCount : 0,
+           stats.maxWait, stats.abandoned);
+}
+
+const char* ApproachTracker::stateName(ApproachState state) {
+  switch (state) {
+    case APPROACH_APPROACHING: return "APPROACHING";
+    case APPROACH_DEPARTING:   return "DEPARTING";
+    case APPROACH_STATIONARY:  return "STATIONARY";
+    case APPROACH_PASSING:     return "PASSING";
+    default:                   return "NONE";
+  }
+}
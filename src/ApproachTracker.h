@@ -0,0 +1,100 @@
+// ApproachTracker.h
+#ifndef APPROACH_TRACKER_H
+#define APPROACH_TRACKER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "Logger.h"
+
+// ============================================
+// APPROACH STATE
+// ============================================
+enum ApproachState : uint8_t {
+  APPROACH_NONE,          // nothing in range
+  APPROACH_APPROACHING,   // closing in on the door
+  APPROACH_DEPARTING,     // moving away
+  APPROACH_STATIONARY,    // in range, not moving
+  APPROACH_PASSING        // left range without ever coming close
+};
+
+struct ApproachStats {
+  unsigned long approaches;
+  unsigned long passings;
+  unsigned long preOpens;
+  unsigned long falsePreOpens;   // no arrival within APPROACH_PREOPEN_TIMEOUT
+  unsigned long arrivals;
+  unsigned long abandoned;       // left before the door opened
+  unsigned long waitCount;       // measured waits (pre-opened = 0 ms)
+  unsigned long totalWait;       // ms from arrival to door fully open
+  unsigned long maxWait;
+};
+
+// ============================================
+// CLASS APPROACH TRACKER
+// ============================================
+// Keeps the last APPROACH_HISTORY outside-distance samples per bay and
+// fits a least-squares line through them: the slope is the approach
+// velocity (cm/s, negative = closing in) and distance / speed gives the
+// ETA at VEHICLE_DETECT_DISTANCE. With APPROACH_PREOPEN the door is
+// opened ahead of the arrival, but only for an authorised pattern: an
+// approach inside APPROACH_HINT_WINDOW of an MQTT arrival hint.
+class ApproachTracker {
+private:
+  uint8_t bayCount;
+
+  // Sample rings (per bay, structure-of-arrays like BayRegistry)
+  float sampleDistance[BAY_MAX][APPROACH_HISTORY];
+  unsigned long sampleTime[BAY_MAX][APPROACH_HISTORY];
+  uint8_t sampleHead[BAY_MAX];
+  uint8_t sampleCount[BAY_MAX];
+
+  ApproachState state[BAY_MAX];
+  float velocity[BAY_MAX];
+  float minDistance[BAY_MAX];    // closest point of the current track
+
+  // One bit per bay
+  uint8_t hintMask;       // unexpired arrival hint
+  uint8_t preOpenMask;    // pre-opened, arrival not seen yet
+  uint8_t waitMask;       // arrived, door not open yet
+  unsigned long hintAt[BAY_MAX];
+  unsigned long preOpenAt[BAY_MAX];
+  unsigned long arrivedAt[BAY_MAX];
+
+  ApproachStats stats;
+
+  void fit(uint8_t bay);
+  void resetTrack(uint8_t bay);
+
+public:
+  ApproachTracker();
+
+  void begin(uint8_t count);
+
+  // Feed one outside-distance sample. Returns true if the state changed.
+  // MAX_DISTANCE (echo timeout) counts as a missing sample.
+  bool addSample(uint8_t bay, float distance, unsigned long now);
+
+  ApproachState getState(uint8_t bay);
+  float getVelocity(uint8_t bay);       // cm/s, negative = approaching
+  long getEtaMs(uint8_t bay);           // -1 when not approaching
+
+  // Arrival hint from the backend (e.g. the owner's phone is nearby)
+  void hint(uint8_t bay, unsigned long now);
+
+  // Predictive opening
+  bool shouldPreOpen(uint8_t bay, unsigned long now);
+  void onPreOpen(uint8_t bay, unsigned long now);
+  bool preOpenExpired(uint8_t bay, unsigned long now);   // counts a false pre-open
+
+  // Driver wait metrics
+  void onArrival(uint8_t bay, unsigned long now, bool doorOpen);
+  void onDeparture(uint8_t bay);
+  void onDoorOpened(uint8_t bay, unsigned long now);
+
+  const ApproachStats& getStats();
+  void printStats();
+
+  static const char* stateName(ApproachState state);
+};
+
+#endif
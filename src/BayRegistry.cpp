@@ -0,0 +1,177 @@
+// BayRegistry.cpp
+#include "BayRegistry.h"
+#include "SensorModule.h"
+
+static_assert(BAY_MAX <= 8, "bay change masks are 8 bits wide");
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+BayRegistry::BayRegistry() {
+  bayCount = 0;
+  cursor = 0;
+  vehicleMask = 0;
+  alertMask = 0;
+}
+
+// ============================================
+// BEGIN
+// ============================================
+
+void BayRegistry::begin(const BayConfig* table, uint8_t count) {
+  bayCount = (count > BAY_MAX) ? BAY_MAX : count;
+
+  for (uint8_t b = 0; b < bayCount; b++) {
+    const BayConfig& cfg = table[b];
+
+    trigPin[b * 2]     = cfg.trigOutside;
+    echoPin[b * 2]     = cfg.echoOutside;
+    trigPin[b * 2 + 1] = cfg.trigInside;
+    echoPin[b * 2 + 1] = cfg.echoInside;
+    distanceMm[b * 2]     = MAX_DISTANCE * 10;
+    distanceMm[b * 2 + 1] = MAX_DISTANCE * 10;
+
+    pinMode(cfg.trigOutside, OUTPUT);
+    pinMode(cfg.echoOutside, INPUT);
+    pinMode(cfg.trigInside, OUTPUT);
+    pinMode(cfg.echoInside, INPUT);
+    pinMode(cfg.ledOutside, OUTPUT);
+    digitalWrite(cfg.ledOutside, LOW);
+
+    ledPin[b] = cfg.ledOutside;
+    servo[b].attach(cfg.servoDoor);
+    servo[b].write(0);
+    doorState[b] = DOOR_CLOSED;
+    doorAngle[b] = 0;
+    vehicleSince[b] = 0;
+  }
+
+  LOG_INFO("  ✓%u bay(s) registered", bayCount);
+}
+
+// ============================================
+// ACQUISITION (round-robin)
+// ============================================
+
+bool BayRegistry::acquire() {
+  if (bayCount == 0) return false;
+
+  distanceMm[cursor] = readUltrasonicMm(echoPin[cursor], trigPin[cursor]);
+
+  cursor++;
+  if (cursor >= bayCount * 2) {
+    cursor = 0;
+    return true;
+  }
+  return false;
+}
+
+// ============================================
+// DETECTION (all bays per pass)
+// ============================================
+
+BayChanges BayRegistry::detect(unsigned long now) {
+  BayChanges changes = { 0, 0, 0 };
+
+  const uint16_t detectMm = VEHICLE_DETECT_DISTANCE * 10;
+
+  uint8_t present = 0;
+  for (uint8_t b = 0; b < bayCount; b++) {
+    present |= (distanceMm[b * 2] < detectMm) << b;
+  }
+
+  changes.arrived = present & ~vehicleMask;
+  changes.left = vehicleMask & ~present;
+
+  for (uint8_t b = 0; b < bayCount; b++) {
+    uint8_t bit = 1 << b;
+    if (changes.arrived & bit) vehicleSince[b] = now;
+
+    if ((present & bit) && !(changes.arrived & bit) && !(alertMask & bit) &&
+        doorState[b] == DOOR_CLOSED &&
+        now - vehicleSince[b] > WAIT_RESPONSE_TIME) {
+      changes.timedOut |= bit;
+    }
+  }
+
+  alertMask |= changes.timedOut;
+  vehicleMask = present;
+  return changes;
+}
+
+// A re-armed bay reports a vehicle that is still waiting as a new arrival
+void BayRegistry::rearm(uint8_t bay) {
+  uint8_t bit = 1 << bay;
+  alertMask &= ~bit;
+  vehicleMask &= ~bit;
+}
+
+// ============================================
+// ACCESSORS
+// ============================================
+
+uint8_t BayRegistry::count() {
+  return bayCount;
+}
+
+float BayRegistry::distanceOutside(uint8_t bay) {
+  return (bay < bayCount) ? distanceMm[bay * 2] / 10.0 : MAX_DISTANCE;
+}
+
+float BayRegistry::distanceInside(uint8_t bay) {
+  return (bay < bayCount) ? distanceMm[bay * 2 + 1] / 10.0 : MAX_DISTANCE;
+}
+
+bool BayRegistry::vehiclePresent(uint8_t bay) {
+  return vehicleMask & (1 << bay);
+}
+
+DoorState BayRegistry::getDoorState(uint8_t bay) {
+  return (bay < bayCount) ? doorState[bay] : DOOR_CLOSED;
+}
+
+void BayRegistry::setDoorState(uint8_t bay, DoorState state) {
+  if (bay < bayCount) doorState[bay] = state;
+}
+
+bool BayRegistry::allDoorsClosed() {
+  for (uint8_t b = 0; b < bayCount; b++) {
+    if (doorState[b] != DOOR_CLOSED) return false;
+  }
+  return true;
+}
+
+// ============================================
+// DOOR SWEEP (one step per call)
+// ============================================
+
+bool BayRegistry::stepDoor(uint8_t bay) {
+  if (bay >= bayCount) return false;
+
+  if (doorState[bay] == DOOR_OPENING) {
+    doorAngle[bay] = min(doorAngle[bay] + DOOR_STEP_ANGLE, DOOR_OPEN_ANGLE);
+    servo[bay].write(doorAngle[bay]);
+    if (doorAngle[bay] < DOOR_OPEN_ANGLE) return false;
+    doorState[bay] = DOOR_OPEN;
+    return true;
+  }
+
+  if (doorState[bay] == DOOR_CLOSING) {
+    doorAngle[bay] = max(doorAngle[bay] - DOOR_STEP_ANGLE, 0);
+    servo[bay].write(doorAngle[bay]);
+    if (doorAngle[bay] > 0) return false;
+    doorState[bay] = DOOR_CLOSED;
+    return true;
+  }
+
+  return false;
+}
+
+Servo& BayRegistry::doorServo(uint8_t bay) {
+  return servo[bay];
+}
+
+uint8_t BayRegistry::outsideLed(uint8_t bay) {
+  return ledPin[bay];
+}
@@ -0,0 +1,77 @@
+// BayRegistry.h
+#ifndef BAY_REGISTRY_H
+#define BAY_REGISTRY_H
+
+#include <Arduino.h>
+#include <ESP32Servo.h>
+#include "config.h"
+#include "Logger.h"
+
+// ============================================
+// DETECTION RESULT
+// ============================================
+// One bit per bay (bit i = bay i)
+struct BayChanges {
+  uint8_t arrived;    // vehicle appeared in front of the door
+  uint8_t left;       // vehicle went away
+  uint8_t timedOut;   // waited WAIT_RESPONSE_TIME with the door closed
+};
+
+// ============================================
+// CLASS BAY REGISTRY
+// ============================================
+// Structure-of-arrays view of every bay: ultrasonic channels are stored
+// as [bay0 out, bay0 in, bay1 out, bay1 in, ...] and pinged one per
+// acquire() call so neighbouring sensors never fire at the same time.
+class BayRegistry {
+private:
+  uint8_t bayCount;
+
+  // Ultrasonic channels (2 per bay)
+  uint8_t trigPin[BAY_MAX * 2];
+  uint8_t echoPin[BAY_MAX * 2];
+  uint16_t distanceMm[BAY_MAX * 2];
+  uint8_t cursor;
+
+  // Per-bay state
+  uint8_t ledPin[BAY_MAX];
+  Servo servo[BAY_MAX];
+  DoorState doorState[BAY_MAX];
+  int doorAngle[BAY_MAX];
+  unsigned long vehicleSince[BAY_MAX];
+  uint8_t vehicleMask;
+  uint8_t alertMask;      // timed out, alert still running
+
+public:
+  BayRegistry();
+
+  void begin(const BayConfig* table, uint8_t count);
+
+  // Ping the next ultrasonic channel. Blocks for the echo, up to
+  // ULTRASONIC_TIMEOUT. Returns true when a full sweep over all
+  // channels has completed.
+  bool acquire();
+
+  // Evaluate vehicle presence for every bay in one pass. A timed-out
+  // bay stays quiet until rearm() is called at the end of its alert.
+  BayChanges detect(unsigned long now);
+  void rearm(uint8_t bay);
+
+  uint8_t count();
+  float distanceOutside(uint8_t bay);
+  float distanceInside(uint8_t bay);
+  bool vehiclePresent(uint8_t bay);
+
+  // Door actuation
+  DoorState getDoorState(uint8_t bay);
+  void setDoorState(uint8_t bay, DoorState state);
+  bool allDoorsClosed();
+
+  // Move an opening/closing door one DOOR_STEP_ANGLE.
+  // Returns true when the sweep has just finished.
+  bool stepDoor(uint8_t bay);
+  Servo& doorServo(uint8_t bay);
+  uint8_t outsideLed(uint8_t bay);
+};
+
+#endif
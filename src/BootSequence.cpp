@@ -0,0 +1,155 @@
+// BootSequence.cpp
+#include "BootSequence.h"
+#include <esp_system.h>
+
+static const char* const PHASE_NAMES[BOOT_PHASE_COUNT] = {
+  "safety", "first_sample", "wifi", "mqtt", "notifier", "thingspeak", "stages_done"
+};
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+BootSequence::BootSequence(PubSubClient& mqtt) : client(mqtt) {
+  stageCount = 0;
+  current = 0;
+  phaseMask = 0;
+  published = false;
+  memset(phaseAt, 0, sizeof(phaseAt));
+}
+
+bool BootSequence::addStage(const char* name, BootStageFunction fn) {
+  if (stageCount >= BOOT_MAX_STAGES || fn == nullptr) return false;
+
+  BootStage& stage = stages[stageCount++];
+  stage.name = name;
+  stage.fn = fn;
+  stage.busy = 0;
+  stage.doneAt = 0;
+  return true;
+}
+
+// ============================================
+// STAGES
+// ============================================
+
+bool BootSequence::step() {
+  if (current >= stageCount) return true;
+
+  BootStage& stage = stages[current];
+  unsigned long start = millis();
+  bool done = stage.fn();
+  stage.busy += millis() - start;
+
+  if (!done) return false;
+
+  stage.doneAt = millis();
+  LOG_INFO("[Boot] ✓ Stage %s done at %lu ms (%lu ms busy)", stage.name, stage.doneAt, stage.busy);
+
+  if (++current < stageCount) return false;
+
+  mark(BOOT_STAGES_DONE);
+  return true;
+}
+
+bool BootSequence::isDone() {
+  return current >= stageCount;
+}
+
+// ============================================
+// PHASES
+// ============================================
+
+void BootSequence::mark(BootPhase phase) {
+  if (phase >= BOOT_PHASE_COUNT || isMarked(phase)) return;
+
+  phaseAt[phase] = millis();
+  phaseMask |= (1 << phase);
+  LOG_INFO("[Boot] ⏱️ %s at %lu ms", PHASE_NAMES[phase], phaseAt[phase]);
+}
+
+bool BootSequence::isMarked(BootPhase phase) {
+  return phaseMask & (1 << phase);
+}
+
+// {"reset":"POWERON","time_to_first_sample":142,"time_to_cloud":3380,
+//  "phases":{"safety":118,...,"thingspeak":null},
+//  "stages":[{"name":"wifi","done":161,"busy":3},...]}
+bool BootSequence::publish() {
+  if (published) return true;
+  if (!isDone() || !client.connected()) return false;
+
+  // The first ThingSpeak upload usually lands shortly after the stages;
+  // give it BOOT_REPORT_WAIT before reporting it as null
+  if (!isMarked(BOOT_THINGSPEAK_UPLOAD) &&
+      millis() - phaseAt[BOOT_STAGES_DONE] < BOOT_REPORT_WAIT) return false;
+
+  char json[MQTT_BUFFER_SIZE - 64];   // leave room for MQTT header + topic
+  size_t len = 0;
+
+  len += snprintf(json + len, sizeof(json) - len, "{\"reset\":\"%s\"", resetReasonName());
+
+  const BootPhase headline[] = { BOOT_FIRST_SAMPLE, BOOT_MQTT_CONNECTED };
+  const char* headlineKeys[] = { "time_to_first_sample", "time_to_cloud" };
+  for (uint8_t i = 0; i < 2 && len < sizeof(json); i++) {
+    if (isMarked(headline[i])) {
+      len += snprintf(json + len, sizeof(json) - len, ",\"%s\":%lu", headlineKeys[i], phaseAt[headline[i]]);
+    } else {
+      len += snprintf(json + len, sizeof(json) - len, ",\"%s\":null", headlineKeys[i]);
+    }
+  }
+
+  for (uint8_t p = 0; p < BOOT_PHASE_COUNT && len < sizeof(json); p++) {
+    const char* open = (p == 0) ? ",\"phases\":{" : ",";
+    if (isMarked((BootPhase)p)) {
+      len += snprintf(json + len, sizeof(json) - len, "%s\"%s\":%lu", open, PHASE_NAMES[p], phaseAt[p]);
+    } else {
+      len += snprintf(json + len, sizeof(json) - len, "%s\"%s\":null", open, PHASE_NAMES[p]);
+    }
+  }
+
+  for (uint8_t s = 0; s < stageCount && len < sizeof(json); s++) {
+    len += snprintf(json + len, sizeof(json) - len, "%s{\"name\":\"%s\",\"done\":%lu,\"busy\":%lu}",
+                    (s == 0) ? "},\"stages\":[" : ",", stages[s].name, stages[s].doneAt, stages[s].busy);
+  }
+
+  if (len < sizeof(json)) {
+    len += snprintf(json + len, sizeof(json) - len, stageCount > 0 ? "]}" : "}}");
+  }
+
+  if (len >= sizeof(json)) {
+    LOG_WARN("[Boot] Report truncated, not published");
+    published = true;
+    return true;
+  }
+
+  published = client.publish(TOPIC_DIAG_BOOT, json, true);
+  if (published) {
+    LOG_INFO("[Boot] 📤 Timeline published (first sample %lu ms, cloud %lu ms)",
+             phaseAt[BOOT_FIRST_SAMPLE], phaseAt[BOOT_MQTT_CONNECTED]);
+  }
+  return published;
+}
+
+// ============================================
+// UTILITIES
+// ============================================
+
+const char* BootSequence::phaseName(BootPhase phase) {
+  return phase < BOOT_PHASE_COUNT ? PHASE_NAMES[phase] : "?";
+}
+
+const char* BootSequence::resetReasonName() {
+  switch (esp_reset_reason()) {
+    case ESP_RST_POWERON:   return "POWERON";
+    case ESP_RST_EXT:       return "EXTERNAL";
+    case ESP_RST_SW:        return "SOFTWARE";
+    case ESP_RST_PANIC:     return "PANIC";
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:       return "WATCHDOG";
+    case ESP_RST_DEEPSLEEP: return "DEEPSLEEP";
+    case ESP_RST_BROWNOUT:  return "BROWNOUT";
+    default:                return "UNKNOWN";
+  }
+}
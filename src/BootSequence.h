@@ -0,0 +1,74 @@
+// BootSequence.h
+#ifndef BOOT_SEQUENCE_H
+#define BOOT_SEQUENCE_H
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include "config.h"
+#include "Logger.h"
+
+// ============================================
+// BOOT PHASES
+// ============================================
+// Milestones, in millis() since reset. Each is stamped once.
+enum BootPhase : uint8_t {
+  BOOT_SAFETY_READY,            // GPIO, servos, sensors, alarm rules
+  BOOT_FIRST_SAMPLE,            // first sensor sample evaluated
+  BOOT_WIFI_CONNECTED,
+  BOOT_MQTT_CONNECTED,          // time-to-cloud
+  BOOT_NOTIFIER_READY,
+  BOOT_THINGSPEAK_UPLOAD,
+  BOOT_STAGES_DONE,
+  BOOT_PHASE_COUNT
+};
+
+// Returns false to be called again on the next step
+typedef bool (*BootStageFunction)();
+
+struct BootStage {
+  const char* name;
+  BootStageFunction fn;
+  unsigned long busy;           // ms spent inside fn
+  unsigned long doneAt;         // millis() when it returned true
+};
+
+// ============================================
+// CLASS BOOT SEQUENCE
+// ============================================
+// Runs the deferred boot stages in order, one step per call, and
+// publishes the phase timeline (retained) once MQTT is up, the last
+// stage has finished and the first ThingSpeak upload is in (or
+// BOOT_REPORT_WAIT has passed without one).
+class BootSequence {
+private:
+  PubSubClient& client;
+  BootStage stages[BOOT_MAX_STAGES];
+  uint8_t stageCount;
+  uint8_t current;
+  unsigned long phaseAt[BOOT_PHASE_COUNT];
+  uint8_t phaseMask;
+  bool published;
+
+  static const char* resetReasonName();
+
+public:
+  BootSequence(PubSubClient& mqtt);
+
+  bool addStage(const char* name, BootStageFunction fn);
+
+  // Run the current stage once; returns true when all stages are done
+  bool step();
+  bool isDone();
+
+  // Later marks of the same phase are ignored
+  void mark(BootPhase phase);
+  bool isMarked(BootPhase phase);
+
+  // Publishes to TOPIC_DIAG_BOOT once; false until MQTT is connected,
+  // all stages are done and the ThingSpeak upload is marked or overdue
+  bool publish();
+
+  static const char* phaseName(BootPhase phase);
+};
+
+#endif
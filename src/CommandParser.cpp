@@ -0,0 +1,39 @@
+// CommandParser.cpp
+#include "CommandParser.h"
+
+// ============================================
+// PAYLOAD
+// ============================================
+
+String CommandParser::payloadToString(const byte* payload, unsigned int length) {
+  String message = "";
+  for (unsigned int i = 0; i < length; i++) {
+    message += (char)payload[i];
+  }
+  return message;
+}
+
+// ============================================
+// COMMANDS
+// ============================================
+
+bool CommandParser::parseDoor(const String& command, uint8_t bayCount, DoorCommand& cmd) {
+  cmd.action = command;
+  cmd.id = LatencyTracer::splitCorrelationId(cmd.action);
+  cmd.bay = 0;
+
+  int sep = cmd.action.indexOf(':');
+  if (sep > 0) {
+    cmd.bay = cmd.action.substring(sep + 1).toInt();
+    cmd.action = cmd.action.substring(0, sep);
+  }
+
+  return cmd.bay >= 0 && cmd.bay < bayCount &&
+         (cmd.action == "OPEN" || cmd.action == "CLOSE");
+}
+
+AlarmCommand CommandParser::parseAlarm(const String& command) {
+  if (command == "ON") return ALARM_CMD_ON;
+  if (command == "OFF") return ALARM_CMD_OFF;
+  return ALARM_CMD_NONE;
+}
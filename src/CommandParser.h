@@ -0,0 +1,42 @@
+// CommandParser.h
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "LatencyTracer.h"
+
+// ============================================
+// COMMANDS
+// ============================================
+struct DoorCommand {
+  String action;    // "OPEN" / "CLOSE"
+  int bay;
+  String id;        // correlation ID, "" if untraced
+};
+
+enum AlarmCommand : uint8_t {
+  ALARM_CMD_NONE,
+  ALARM_CMD_ON,
+  ALARM_CMD_OFF
+};
+
+// ============================================
+// CLASS COMMAND PARSER
+// ============================================
+// MQTT and dashboard command payloads. Pure string handling, no
+// actuation, so the host benchmarks run the same code as the board.
+class CommandParser {
+public:
+  static String payloadToString(const byte* payload, unsigned int length);
+
+  // "OPEN" / "CLOSE" address bay 0, "OPEN:<bay>" / "CLOSE:<bay>" any bay
+  // below bayCount. A "#<id>" suffix ("OPEN:1#a1b2") traces the command
+  // end to end.
+  static bool parseDoor(const String& command, uint8_t bayCount, DoorCommand& cmd);
+
+  // "ON" / "OFF"
+  static AlarmCommand parseAlarm(const String& command);
+};
+
+#endif
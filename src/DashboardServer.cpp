@@ -0,0 +1,218 @@
+// DashboardServer.cpp
+#include "DashboardServer.h"
+
+// The longest frame is a traced door command with a full correlation ID
+static_assert(DASHBOARD_FRAME_MAX >= sizeof("door:CLOSE:0#") + TRACE_ID_SIZE - 1,
+              "DASHBOARD_FRAME_MAX cannot hold a traced door command");
+
+// ============================================
+// STATIC PAGE
+// ============================================
+static const char DASHBOARD_HTML[] PROGMEM = R"HTML(<!DOCTYPE html>
+<html><head><meta charset="utf-8"><meta name="viewport" content="width=device-width">
+<title>Smart Garage</title>
+<style>body{font-family:sans-serif;margin:1em}td{padding:2px 12px}button{margin:4px;padding:8px 16px}</style>
+</head><body>
+<h2>Smart Garage</h2>
+<table>
+<tr><td>Temperature</td><td id="temp">-</td></tr>
+<tr><td>Humidity</td><td id="hum">-</td></tr>
+<tr><td>Smoke</td><td id="smoke">-</td></tr>
+<tr><td>Distance out (bay 0)</td><td id="out">-</td></tr>
+<tr><td>Distance in (bay 0)</td><td id="in">-</td></tr>
+<tr><td>PIR</td><td id="pir">-</td></tr>
+<tr><td>Alarm</td><td id="alarm">-</td></tr>
+</table>
+<table id="bays"></table>
+<button onclick="s('alarm:ON')">Alarm on</button><button onclick="s('alarm:OFF')">Alarm off</button>
+<p id="st">connecting...</p>
+<script>
+var w;function $(i){return document.getElementById(i)}
+function s(c){if(w&&w.readyState==1)w.send(c)}
+function c(){w=new WebSocket('ws://'+location.host+'/ws');
+w.onopen=function(){$('st').textContent='live'};
+w.onclose=function(){$('st').textContent='reconnecting...';setTimeout(c,2000)};
+w.onmessage=function(e){var d=JSON.parse(e.data);
+if(d.type=='sensors'){for(var k in d)if($(k))$(k).textContent=d[k]}
+else if(d.type=='door')bay(d.bay).textContent=d.state;
+else if($(d.type))$(d.type).textContent=d.state}}
+function bay(b){var e=$('door'+b);if(e)return e;
+var r=$('bays').insertRow();r.innerHTML='<td>Door '+b+'</td><td id="door'+b+'">-</td><td>'+
+'<button onclick="s(\'door:OPEN:'+b+'\')">Open</button><button onclick="s(\'door:CLOSE:'+b+'\')">Close</button></td>';
+return $('door'+b)}
+c();
+</script></body></html>
+)HTML";
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+DashboardServer::DashboardServer() : server(DASHBOARD_PORT), ws("/ws") {
+  commandQueue = nullptr;
+  commandHandler = nullptr;
+  started = false;
+  sensorJson[0] = '\0';
+  for (uint8_t b = 0; b < BAY_MAX; b++) doorStatus[b] = "CLOSED";
+  bayCount = 0;
+  alarmStatus = "OFF";
+  lastCleanup = 0;
+  droppedCommands = 0;
+}
+
+// ============================================
+// BEGIN
+// ============================================
+
+void DashboardServer::begin(DashboardCommandHandler handler, uint8_t bays) {
+  commandHandler = handler;
+  bayCount = min(bays, (uint8_t)BAY_MAX);
+  commandQueue = xQueueCreate(DASHBOARD_QUEUE_SIZE, sizeof(DashboardCommand));
+
+  ws.onEvent([this](AsyncWebSocket* server, AsyncWebSocketClient* client,
+                    AwsEventType type, void* arg, uint8_t* data, size_t len) {
+    onWsEvent(client, type, arg, data, len);
+  });
+  server.addHandler(&ws);
+
+  server.on("/", HTTP_GET, [](AsyncWebServerRequest* request) {
+    request->send_P(200, "text/html", DASHBOARD_HTML);
+  });
+  server.onNotFound([](AsyncWebServerRequest* request) {
+    request->send(404, "text/plain", "Not found");
+  });
+
+  server.begin();
+  started = true;
+
+  LOG_INFO("[Dashboard] Listening on port %d", DASHBOARD_PORT);
+}
+
+// ============================================
+// WEBSOCKET EVENTS (AsyncTCP task)
+// ============================================
+
+void DashboardServer::queueCommand(DashboardTarget target, uint32_t clientId, const char* command) {
+  DashboardCommand cmd;
+  cmd.target = target;
+  cmd.clientId = clientId;
+  strncpy(cmd.command, command, sizeof(cmd.command) - 1);
+  cmd.command[sizeof(cmd.command) - 1] = '\0';
+
+  if (xQueueSend(commandQueue, &cmd, 0) != pdTRUE) {
+    droppedCommands++;
+  }
+}
+
+void DashboardServer::onWsEvent(AsyncWebSocketClient* client, AwsEventType type,
+                                void* arg, uint8_t* data, size_t len) {
+  if (type == WS_EVT_CONNECT) {
+    if (ws.count() > DASHBOARD_MAX_CLIENTS) {
+      client->close();
+      return;
+    }
+    queueCommand(DASH_SNAPSHOT, client->id(), "");
+    return;
+  }
+
+  if (type != WS_EVT_DATA) return;
+
+  // Only single-frame text messages - commands are a few bytes long
+  AwsFrameInfo* info = (AwsFrameInfo*)arg;
+  if (!info->final || info->index != 0 || info->len != len || info->opcode != WS_TEXT) return;
+  if (len >= DASHBOARD_FRAME_MAX) return;
+
+  char text[DASHBOARD_FRAME_MAX];
+  memcpy(text, data, len);
+  text[len] = '\0';
+
+  if (strncmp(text, "door:", 5) == 0) {
+    queueCommand(DASH_DOOR, client->id(), text + 5);
+  } else if (strncmp(text, "alarm:", 6) == 0) {
+    queueCommand(DASH_ALARM, client->id(), text + 6);
+  }
+}
+
+// ============================================
+// LOOP
+// ============================================
+
+void DashboardServer::loop() {
+  if (!started) return;
+
+  DashboardCommand cmd;
+  while (xQueueReceive(commandQueue, &cmd, 0) == pdTRUE) {
+    if (cmd.target == DASH_SNAPSHOT) {
+      if (sensorJson[0] != '\0') ws.text(cmd.clientId, sensorJson);
+      for (uint8_t b = 0; b < bayCount; b++) sendDoorState(b, cmd.clientId);
+      sendState("alarm", alarmStatus, cmd.clientId);
+    } else if (commandHandler != nullptr) {
+      LOG_INFO("[Dashboard] Command from client %lu: %s", cmd.clientId, logCopy(cmd.command));
+      commandHandler(cmd.target, String(cmd.command));
+    }
+  }
+
+  unsigned long now = millis();
+  if (now - lastCleanup >= 1000) {
+    lastCleanup = now;
+    ws.cleanupClients(DASHBOARD_MAX_CLIENTS);
+  }
+}
+
+// ============================================
+// STATE PUSH
+// ============================================
+
+// clientId 0 = every connected client (AsyncWebSocket ids start at 1)
+void DashboardServer::sendState(const char* kind, const char* state, uint32_t clientId) {
+  char json[48];
+  snprintf(json, sizeof(json), "{\"type\":\"%s\",\"state\":\"%s\"}", kind, state);
+
+  if (clientId == 0) {
+    ws.textAll(json);
+  } else {
+    ws.text(clientId, json);
+  }
+}
+
+void DashboardServer::sendDoorState(uint8_t bay, uint32_t clientId) {
+  char json[56];
+  snprintf(json, sizeof(json), "{\"type\":\"door\",\"bay\":%u,\"state\":\"%s\"}", bay, doorStatus[bay]);
+
+  if (clientId == 0) {
+    ws.textAll(json);
+  } else {
+    ws.text(clientId, json);
+  }
+}
+
+void DashboardServer::pushSensorData(const SensorData& data) {
+  // A failed DHT read is NaN, which JSON cannot carry
+  char temp[12] = "null";
+  char hum[12] = "null";
+  if (!isnan(data.temperatureDHT)) snprintf(temp, sizeof(temp), "%.1f", data.temperatureDHT);
+  if (!isnan(data.humidity)) snprintf(hum, sizeof(hum), "%.1f", data.humidity);
+
+  snprintf(sensorJson, sizeof(sensorJson),
+           "{\"type\":\"sensors\",\"temp\":%s,\"hum\":%s,\"smoke\":%d,"
+           "\"out\":%.1f,\"in\":%.1f,\"pir\":%d}",
+           temp, hum, data.smokeLevel,
+           data.distanceOutside, data.distanceInside, data.pirMotion ? 1 : 0);
+
+  if (started && ws.count() > 0) ws.textAll(sensorJson);
+}
+
+void DashboardServer::pushDoorStatus(uint8_t bay, const char* status) {
+  if (bay >= bayCount) return;
+  doorStatus[bay] = status;
+  if (started && ws.count() > 0) sendDoorState(bay, 0);
+}
+
+void DashboardServer::pushAlarmStatus(const char* status) {
+  alarmStatus = status;
+  if (started && ws.count() > 0) sendState("alarm", status, 0);
+}
+
+int DashboardServer::clientCount() {
+  return started ? ws.count() : 0;
+}
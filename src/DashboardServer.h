@@ -0,0 +1,74 @@
+// DashboardServer.h
+#ifndef DASHBOARD_SERVER_H
+#define DASHBOARD_SERVER_H
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "config.h"
+#include "Logger.h"
+#include "SensorModule.h"
+
+// ============================================
+// COMMANDS
+// ============================================
+// WebSocket text frames from the page: "door:OPEN:<bay>",
+// "door:CLOSE:<bay>", "alarm:ON", "alarm:OFF". They are queued from the AsyncTCP task and
+// applied in loop() so they run with the same semantics as mqttCallback().
+enum DashboardTarget : uint8_t {
+  DASH_DOOR,
+  DASH_ALARM,
+  DASH_SNAPSHOT      // new client - send current state
+};
+
+struct DashboardCommand {
+  DashboardTarget target;
+  uint32_t clientId;
+  char command[DASHBOARD_FRAME_MAX];   // "CLOSE:1#a1b2" etc.
+};
+
+typedef void (*DashboardCommandHandler)(DashboardTarget target, const String& command);
+
+// ============================================
+// CLASS DASHBOARD SERVER
+// ============================================
+class DashboardServer {
+private:
+  AsyncWebServer server;
+  AsyncWebSocket ws;
+  QueueHandle_t commandQueue;
+  DashboardCommandHandler commandHandler;
+  bool started;
+
+  // Last known state, only touched from loop()
+  char sensorJson[160];
+  const char* doorStatus[BAY_MAX];
+  uint8_t bayCount;
+  const char* alarmStatus;
+  unsigned long lastCleanup;
+  unsigned long droppedCommands;
+
+  void onWsEvent(AsyncWebSocketClient* client, AwsEventType type,
+                 void* arg, uint8_t* data, size_t len);
+  void queueCommand(DashboardTarget target, uint32_t clientId, const char* command);
+  void sendState(const char* kind, const char* state, uint32_t clientId);
+  void sendDoorState(uint8_t bay, uint32_t clientId);
+
+public:
+  DashboardServer();
+
+  // The page shows one door row per bay
+  void begin(DashboardCommandHandler handler, uint8_t bays);
+  void loop();
+
+  // State pushes - no-ops while nobody is connected
+  void pushSensorData(const SensorData& data);
+  void pushDoorStatus(uint8_t bay, const char* status);
+  void pushAlarmStatus(const char* status);
+
+  int clientCount();
+};
+
+#endif
@@ -0,0 +1,125 @@
+// DeadbandPublisher.cpp
+#include "DeadbandPublisher.h"
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+DeadbandPublisher::DeadbandPublisher(PubSubClient& mqtt) : client(mqtt) {
+  channelCount = 0;
+  for (int i = 0; i < 6; i++) sensorChannels[i] = -1;
+  maxSilence = 0;
+  changeDriven = false;
+  retained = false;
+}
+
+void DeadbandPublisher::begin(bool changeDriven, unsigned long maxSilence, bool retained) {
+  this->changeDriven = changeDriven;
+  this->maxSilence = maxSilence;
+  this->retained = retained;
+}
+
+int DeadbandPublisher::addChannel(const char* topic, float deadband, uint8_t decimals) {
+  if (channelCount >= DEADBAND_MAX_CHANNELS) return -1;
+
+  DeadbandChannel& ch = channels[channelCount];
+  ch.topic = topic;
+  ch.deadband = deadband;
+  ch.decimals = decimals;
+  ch.lastValue = 0;
+  ch.lastSent = 0;
+  ch.hasValue = false;
+  ch.sent = 0;
+  ch.suppressed = 0;
+
+  return channelCount++;
+}
+
+void DeadbandPublisher::addSensorChannels(const char* temperature, const char* humidity,
+                                          const char* smoke, const char* distanceOut,
+                                          const char* distanceIn, const char* pir) {
+  sensorChannels[0] = addChannel(temperature, DEADBAND_TEMPERATURE, 1);
+  sensorChannels[1] = addChannel(humidity, DEADBAND_HUMIDITY, 1);
+  sensorChannels[2] = addChannel(smoke, DEADBAND_SMOKE, 0);
+  sensorChannels[3] = addChannel(distanceOut, DEADBAND_DISTANCE, 1);
+  sensorChannels[4] = addChannel(distanceIn, DEADBAND_DISTANCE, 1);
+  sensorChannels[5] = addChannel(pir, DEADBAND_PIR, 0);
+}
+
+// ============================================
+// UPDATE
+// ============================================
+
+void DeadbandPublisher::publishSensorData(const SensorData& data) {
+  if (!client.connected()) return;
+
+  update(sensorChannels[0], data.temperatureDHT);
+  update(sensorChannels[1], data.humidity);
+  update(sensorChannels[2], data.smokeLevel);
+  update(sensorChannels[3], data.distanceOutside);
+  update(sensorChannels[4], data.distanceInside);
+  update(sensorChannels[5], data.pirMotion ? 1 : 0, data.pirMotion ? "DETECTED" : "CLEAR");
+}
+
+bool DeadbandPublisher::update(int channel, float value, const char* text) {
+  if (channel < 0 || channel >= channelCount) return false;
+  if (isnan(value)) return false;  // failed sensor read - keep last state
+
+  DeadbandChannel& ch = channels[channel];
+  unsigned long now = millis();
+
+  if (changeDriven && ch.hasValue) {
+    bool moved = fabsf(value - ch.lastValue) > ch.deadband;
+    bool heartbeat = (maxSilence > 0) && (now - ch.lastSent >= maxSilence);
+    if (!moved && !heartbeat) {
+      ch.suppressed++;
+      return false;
+    }
+  }
+
+  char payload[16];
+  if (text == nullptr) {
+    dtostrf(value, 1, ch.decimals, payload);
+    text = payload;
+  }
+
+  if (!client.publish(ch.topic, text, retained)) return false;
+
+  ch.lastValue = value;
+  ch.lastSent = now;
+  ch.hasValue = true;
+  ch.sent++;
+  return true;
+}
+
+void DeadbandPublisher::invalidate() {
+  for (int i = 0; i < channelCount; i++) {
+    channels[i].hasValue = false;
+  }
+}
+
+// ============================================
+// UTILITIES
+// ============================================
+
+unsigned long DeadbandPublisher::getSentCount() {
+  unsigned long total = 0;
+  for (int i = 0; i < channelCount; i++) total += channels[i].sent;
+  return total;
+}
+
+unsigned long DeadbandPublisher::getSuppressedCount() {
+  unsigned long total = 0;
+  for (int i = 0; i < channelCount; i++) total += channels[i].suppressed;
+  return total;
+}
+
+void DeadbandPublisher::printStats() {
+  LOG_INFO("[MQTT] Publishes sent=%lu suppressed=%lu",
+           getSentCount(), getSuppressedCount());
+
+  for (int i = 0; i < channelCount; i++) {
+    LOG_DEBUG("   %s: sent=%lu suppressed=%lu",
+              channels[i].topic, channels[i].sent, channels[i].suppressed);
+  }
+}
@@ -0,0 +1,67 @@
+// DeadbandPublisher.h
+#ifndef DEADBAND_PUBLISHER_H
+#define DEADBAND_PUBLISHER_H
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include "config.h"
+#include "Logger.h"
+#include "SensorModule.h"
+
+// ============================================
+// CHANNEL
+// ============================================
+// A value is published (retained) when it moves more than `deadband`
+// away from the last published value, or when the channel has been
+// silent for maxSilence ms (heartbeat).
+struct DeadbandChannel {
+  const char* topic;
+  float deadband;
+  uint8_t decimals;
+  float lastValue;
+  unsigned long lastSent;
+  bool hasValue;
+  unsigned long sent;
+  unsigned long suppressed;
+};
+
+// ============================================
+// CLASS DEADBAND PUBLISHER
+// ============================================
+class DeadbandPublisher {
+private:
+  PubSubClient& client;
+  DeadbandChannel channels[DEADBAND_MAX_CHANNELS];
+  int channelCount;
+  int sensorChannels[6];   // SensorData fields, see addSensorChannels()
+  unsigned long maxSilence;
+  bool changeDriven;
+  bool retained;
+
+public:
+  DeadbandPublisher(PubSubClient& mqtt);
+
+  // changeDriven = false publishes every update (legacy behaviour)
+  void begin(bool changeDriven, unsigned long maxSilence, bool retained);
+  int addChannel(const char* topic, float deadband, uint8_t decimals);
+
+  // Register the six SensorData channels with the configured deadbands
+  void addSensorChannels(const char* temperature, const char* humidity,
+                         const char* smoke, const char* distanceOut,
+                         const char* distanceIn, const char* pir);
+  void publishSensorData(const SensorData& data);
+
+  // `text` overrides the formatted number, e.g. "DETECTED" for PIR.
+  // Returns true if a message went out.
+  bool update(int channel, float value, const char* text = nullptr);
+
+  // Forget published state so every channel reports on the next update
+  // (call after an MQTT reconnect).
+  void invalidate();
+
+  unsigned long getSentCount();
+  unsigned long getSuppressedCount();
+  void printStats();
+};
+
+#endif
@@ -0,0 +1,188 @@
+// EventBus.cpp
+#include "EventBus.h"
+
+static_assert(EVENT_MAX_SINKS <= 8, "subscriber mask is 8 bits wide");
+static_assert(EVENT_POOL_SIZE <= 255, "pool slots are indexed with uint8_t");
+static_assert(EVENT_SINK_QUEUE_SIZE <= 255, "sink queues are indexed with uint8_t");
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+EventBus::EventBus() {
+  for (uint8_t i = 0; i < EVENT_POOL_SIZE; i++) {
+    freeList[i] = i;
+    pool[i].refCount = 0;
+  }
+  freeCount = EVENT_POOL_SIZE;
+  sinkCount = 0;
+  poolExhausted = 0;
+  memset(subscribers, 0, sizeof(subscribers));
+}
+
+// ============================================
+// REGISTRATION
+// ============================================
+
+int EventBus::addSink(const char* name, EventHandler handler, uint8_t batchSize) {
+  if (sinkCount >= EVENT_MAX_SINKS || handler == nullptr) return -1;
+
+  Sink& sink = sinks[sinkCount];
+  sink.name = name;
+  sink.handler = handler;
+  sink.batchSize = (batchSize == 0) ? 1 : batchSize;
+  sink.head = 0;
+  sink.count = 0;
+  memset(&sink.stats, 0, sizeof(sink.stats));
+
+  return sinkCount++;
+}
+
+bool EventBus::subscribe(int sink, EventType type) {
+  if (sink < 0 || sink >= sinkCount || type >= EVT_TYPE_COUNT) return false;
+  subscribers[type] |= (1 << sink);
+  return true;
+}
+
+// ============================================
+// PUBLISH
+// ============================================
+
+bool EventBus::publish(EventType type, float value1, float value2,
+                       int level, const char* reason, uint8_t bay,
+                       uint8_t trace) {
+  if (type >= EVT_TYPE_COUNT) return false;
+
+  uint8_t mask = subscribers[type];
+  if (mask == 0) return true;  // nobody listening
+
+  if (freeCount == 0) {
+    poolExhausted++;
+    for (uint8_t s = 0; s < sinkCount; s++) {
+      if (mask & (1 << s)) sinks[s].stats.dropped++;
+    }
+    return false;
+  }
+
+  uint8_t slot = freeList[--freeCount];
+  Event& event = pool[slot];
+  event.type = type;
+  event.timestamp = millis();
+  event.value1 = value1;
+  event.value2 = value2;
+  event.level = level;
+  event.reason = reason;
+  event.bay = bay;
+  event.trace = trace;
+  event.refCount = 0;
+
+  for (uint8_t s = 0; s < sinkCount; s++) {
+    if (!(mask & (1 << s))) continue;
+
+    Sink& sink = sinks[s];
+    if (sink.count >= EVENT_SINK_QUEUE_SIZE) {
+      sink.stats.dropped++;
+      continue;
+    }
+    sink.queue[(sink.head + sink.count) % EVENT_SINK_QUEUE_SIZE] = slot;
+    sink.count++;
+    event.refCount++;
+  }
+
+  // Every subscribed queue was full
+  if (event.refCount == 0) {
+    freeList[freeCount++] = slot;
+    return false;
+  }
+  return true;
+}
+
+// ============================================
+// DISPATCH
+// ============================================
+
+void EventBus::release(uint8_t slot) {
+  if (pool[slot].refCount > 0 && --pool[slot].refCount == 0) {
+    freeList[freeCount++] = slot;
+  }
+}
+
+void EventBus::dispatch() {
+  for (uint8_t s = 0; s < sinkCount; s++) {
+    Sink& sink = sinks[s];
+
+    for (uint8_t n = 0; n < sink.batchSize && sink.count > 0; n++) {
+      uint8_t slot = sink.queue[sink.head];
+      sink.head = (sink.head + 1) % EVENT_SINK_QUEUE_SIZE;
+      sink.count--;
+
+      const Event& event = pool[slot];
+      unsigned long start = millis();
+      unsigned long latency = start - event.timestamp;
+
+      sink.handler(event);
+
+      unsigned long handlerTime = millis() - start;
+      sink.stats.delivered++;
+      sink.stats.totalLatency += latency;
+      if (latency > sink.stats.maxLatency) sink.stats.maxLatency = latency;
+      if (handlerTime > sink.stats.maxHandlerTime) sink.stats.maxHandlerTime = handlerTime;
+
+      release(slot);
+    }
+  }
+}
+
+// ============================================
+// UTILITIES
+// ============================================
+
+bool EventBus::isIdle() {
+  return freeCount == EVENT_POOL_SIZE;
+}
+
+int EventBus::freeSlots() {
+  return freeCount;
+}
+
+const SinkStats* EventBus::getSinkStats(int sink) {
+  if (sink < 0 || sink >= sinkCount) return nullptr;
+  return &sinks[sink].stats;
+}
+
+unsigned long EventBus::getPoolExhausted() {
+  return poolExhausted;
+}
+
+void EventBus::printStats() {
+  LOG_INFO("[EventBus] Pool: %d/%d free, exhausted=%lu",
+           freeCount, EVENT_POOL_SIZE, poolExhausted);
+  for (uint8_t s = 0; s < sinkCount; s++) {
+    const SinkStats& st = sinks[s].stats;
+    LOG_INFO("   %s: delivered=%lu dropped=%lu avgLatency=%lums maxLatency=%lums maxHandler=%lums",
+             sinks[s].name, st.delivered, st.dropped,
+             st.delivered ? st.totalLatency / st.delivered : 0,
+             st.maxLatency, st.maxHandlerTime);
+  }
+}
+
+const char* EventBus::typeName(EventType type) {
+  switch (type) {
+    case EVT_DOOR_OPENED:            return "DOOR_OPENED";
+    case EVT_DOOR_CLOSED:            return "DOOR_CLOSED";
+    case EVT_VEHICLE_DETECTED:       return "VEHICLE_DETECTED";
+    case EVT_VEHICLE_LEFT:           return "VEHICLE_LEFT";
+    case EVT_VEHICLE_TIMEOUT:        return "VEHICLE_TIMEOUT";
+    case EVT_VEHICLE_APPROACH:       return "VEHICLE_APPROACH";
+    case EVT_FIRE_ALERT:             return "FIRE_ALERT";
+    case EVT_FIRE_CLEARED:           return "FIRE_CLEARED";
+    case EVT_EXTINGUISHER_ACTIVATED: return "EXTINGUISHER";
+    case EVT_HIGH_TEMPERATURE:       return "HIGH_TEMPERATURE";
+    case EVT_HIGH_SMOKE:             return "HIGH_SMOKE";
+    case EVT_INTRUSION:              return "INTRUSION";
+    case EVT_INTRUSION_CLEARED:      return "INTRUSION_CLEARED";
+    case EVT_ALARM_ON:               return "ALARM_ON";
+    case EVT_ALARM_OFF:              return "ALARM_OFF";
+    default:                         return "UNKNOWN";
+  }
+}
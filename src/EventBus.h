@@ -0,0 +1,121 @@
+// EventBus.h
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "Logger.h"
+
+// ============================================
+// EVENT TYPES
+// ============================================
+enum EventType : uint8_t {
+  EVT_DOOR_OPENED,
+  EVT_DOOR_CLOSED,
+  EVT_VEHICLE_DETECTED,
+  EVT_VEHICLE_LEFT,
+  EVT_VEHICLE_TIMEOUT,
+  EVT_VEHICLE_APPROACH,
+  EVT_FIRE_ALERT,
+  EVT_FIRE_CLEARED,
+  EVT_EXTINGUISHER_ACTIVATED,
+  EVT_HIGH_TEMPERATURE,
+  EVT_HIGH_SMOKE,
+  EVT_INTRUSION,
+  EVT_INTRUSION_CLEARED,
+  EVT_ALARM_ON,
+  EVT_ALARM_OFF,
+  EVT_TYPE_COUNT
+};
+
+// ============================================
+// EVENT STRUCTURE
+// ============================================
+// Payload fields are interpreted per type:
+//   VEHICLE_DETECTED  value1 = distance (cm)
+//   VEHICLE_APPROACH  value1 = velocity (cm/s), value2 = ETA (s), level = ApproachState
+//   FIRE_ALERT        value1 = temperature, value2 = humidity, level = smoke
+//   HIGH_TEMPERATURE  value1 = temperature
+//   HIGH_SMOKE        level  = smoke
+//   DOOR / ALARM      reason = source of the change
+// `bay` identifies the parking bay for door and vehicle events.
+// `reason` must point to a string literal - it is not copied.
+// `trace` is the LatencyTracer slot riding along (0 = untraced).
+struct Event {
+  EventType type;
+  uint8_t refCount;
+  unsigned long timestamp;
+  float value1;
+  float value2;
+  int level;
+  const char* reason;
+  uint8_t bay;
+  uint8_t trace;
+};
+
+typedef void (*EventHandler)(const Event& event);
+
+// ============================================
+// SINK STATISTICS
+// ============================================
+struct SinkStats {
+  unsigned long delivered;
+  unsigned long dropped;        // queue full or pool exhausted
+  unsigned long totalLatency;   // ms, publish -> handler start
+  unsigned long maxLatency;     // ms
+  unsigned long maxHandlerTime; // ms spent inside the handler
+};
+
+// ============================================
+// CLASS EVENT BUS
+// ============================================
+class EventBus {
+private:
+  struct Sink {
+    const char* name;
+    EventHandler handler;
+    uint8_t batchSize;
+    uint8_t queue[EVENT_SINK_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    SinkStats stats;
+  };
+
+  Event pool[EVENT_POOL_SIZE];
+  uint8_t freeList[EVENT_POOL_SIZE];
+  uint8_t freeCount;
+
+  Sink sinks[EVENT_MAX_SINKS];
+  uint8_t sinkCount;
+  uint8_t subscribers[EVT_TYPE_COUNT];  // bitmask of sink indices
+  unsigned long poolExhausted;
+
+  void release(uint8_t slot);
+
+public:
+  EventBus();
+
+  // Register a sink; returns its index or -1 when full.
+  // batchSize = max events handed to this sink per dispatch() call.
+  int addSink(const char* name, EventHandler handler, uint8_t batchSize);
+  bool subscribe(int sink, EventType type);
+
+  // O(1) w.r.t. sink speed: copies the event into the pool and queues
+  // its slot index on every subscribed sink. Never calls a handler.
+  bool publish(EventType type, float value1 = 0, float value2 = 0,
+               int level = 0, const char* reason = "", uint8_t bay = 0,
+               uint8_t trace = 0);
+
+  // Drain up to batchSize events per sink. Call from loop().
+  void dispatch();
+
+  bool isIdle();
+  int freeSlots();
+  const SinkStats* getSinkStats(int sink);
+  unsigned long getPoolExhausted();
+  void printStats();
+
+  static const char* typeName(EventType type);
+};
+
+#endif
@@ -0,0 +1,408 @@
+// FleetSimulator.cpp
+#include "FleetSimulator.h"
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+FleetSimulator::FleetSimulator() : controller(controllerNet) {
+  garageCount = 0;
+  broker = FLEET_SIM_BROKER;
+  port = FLEET_SIM_PORT;
+  churnInterval = FLEET_SIM_CHURN_INTERVAL;
+  rttCount = 0;
+  memset(&stats, 0, sizeof(stats));
+  memset(&lastReport, 0, sizeof(lastReport));
+  memset(commandSentAt, 0, sizeof(commandSentAt));
+  memset(closeDueAt, 0, sizeof(closeDueAt));
+  lastReportTime = 0;
+  lastChurn = 0;
+  lastControllerAttempt = 0;
+  started = false;
+}
+
+// ============================================
+// BEGIN
+// ============================================
+
+void FleetSimulator::setupGarage(int index) {
+  SimGarage& g = garages[index];
+
+  snprintf(g.clientId, sizeof(g.clientId), "SimGarage-%03d-%04lx", index, random(0xffff));
+
+  static const char* const BASE_TOPICS[SIM_TOPIC_COUNT] = {
+    TOPIC_TEMPERATURE, TOPIC_HUMIDITY, TOPIC_SMOKE,
+    TOPIC_DISTANCE_OUT, TOPIC_DISTANCE_IN, TOPIC_PIR,
+    TOPIC_DOOR_CMD, TOPIC_DOOR_STATUS, TOPIC_ALARM_CMD, TOPIC_ALARM_STATUS,
+    TOPIC_VEHICLE_DETECTED
+  };
+  for (int t = 0; t < SIM_TOPIC_COUNT; t++) {
+    snprintf(g.topics[t], sizeof(g.topics[t]), "sim%03d/%s", index, BASE_TOPICS[t]);
+  }
+
+  g.mqtt.setServer(broker, port);
+  g.mqtt.setCallback([this, index](char* topic, byte* payload, unsigned int length) {
+    onGarageMessage(index, topic, payload, length);
+  });
+
+  g.publisher.begin(REPORT_BY_EXCEPTION, PUBLISH_MAX_SILENCE, PUBLISH_RETAINED);
+  g.publisher.addSensorChannels(g.topics[SIM_T_TEMPERATURE], g.topics[SIM_T_HUMIDITY],
+                                g.topics[SIM_T_SMOKE], g.topics[SIM_T_DISTANCE_OUT],
+                                g.topics[SIM_T_DISTANCE_IN], g.topics[SIM_T_PIR]);
+
+  g.scenario = SIM_IDLE;
+  g.phaseStart = millis() + random(FLEET_SIM_PHASE_MS);  // desynchronise garages
+  g.lastSample = 0;
+  g.lastConnectAttempt = 0;
+  g.doorDoneAt = 0;
+  g.door = DOOR_CLOSED;
+  g.alarm = ALARM_OFF;
+  g.vehicleReported = false;
+  g.wasConnected = false;
+}
+
+bool FleetSimulator::begin(const char* host, uint16_t hostPort, int count) {
+  if (strcasecmp(host, MQTT_SERVER) == 0) {
+    LOG_ERROR("[FleetSim] Refusing to load %s - use a local broker", host);
+    return false;
+  }
+
+  broker = host;
+  port = hostPort;
+  garageCount = constrain(count, 1, FLEET_SIM_GARAGES);
+
+  for (int i = 0; i < garageCount; i++) {
+    setupGarage(i);
+  }
+
+  snprintf(controllerId, sizeof(controllerId), "SimController-%04lx", random(0xffff));
+  controller.setServer(broker, port);
+  controller.setCallback([this](char* topic, byte* payload, unsigned int length) {
+    onControllerMessage(topic, payload, length);
+  });
+
+  lastReportTime = millis();
+  lastChurn = millis();
+  started = true;
+
+  LOG_INFO("[FleetSim] %d virtual garages -> %s:%u", garageCount, broker, port);
+  return true;
+}
+
+void FleetSimulator::setChurnInterval(unsigned long ms) {
+  churnInterval = ms;
+  lastChurn = millis();
+}
+
+// ============================================
+// LOOP
+// ============================================
+
+void FleetSimulator::loop() {
+  if (!started || WiFi.status() != WL_CONNECTED) return;
+
+  unsigned long now = millis();
+
+  // Operator session
+  if (!controller.connected()) {
+    if (now - lastControllerAttempt >= MQTT_RETRY_INTERVAL) {
+      lastControllerAttempt = now;
+      if (controller.connect(controllerId)) {
+        controller.subscribe("+/" TOPIC_DOOR_STATUS);
+        controller.subscribe("+/" TOPIC_VEHICLE_DETECTED);
+      }
+    }
+  } else {
+    controller.loop();
+  }
+
+  for (int i = 0; i < garageCount; i++) {
+    serviceGarage(i, now);
+
+    if (closeDueAt[i] != 0 && now >= closeDueAt[i]) {
+      closeDueAt[i] = 0;
+      sendCommand(i, "CLOSE");
+    }
+  }
+
+  // Forced connection churn
+  if (churnInterval > 0 && now - lastChurn >= churnInterval) {
+    lastChurn = now;
+    int victim = random(garageCount);
+    if (garages[victim].mqtt.connected()) {
+      garages[victim].mqtt.disconnect();
+    }
+  }
+
+  if (now - lastReportTime >= FLEET_SIM_REPORT_INTERVAL) {
+    report(now);
+  }
+}
+
+void FleetSimulator::serviceGarage(int index, unsigned long now) {
+  SimGarage& g = garages[index];
+
+  if (!g.mqtt.connected()) {
+    if (g.wasConnected) {
+      g.wasConnected = false;
+      stats.disconnects++;
+    }
+    if (now - g.lastConnectAttempt < MQTT_RETRY_INTERVAL) return;
+    g.lastConnectAttempt = now;
+
+    if (!g.mqtt.connect(g.clientId)) {
+      stats.connectFailures++;
+      return;
+    }
+
+    g.wasConnected = true;
+    stats.connects++;
+    g.mqtt.subscribe(g.topics[SIM_T_DOOR_CMD]);
+    g.mqtt.subscribe(g.topics[SIM_T_ALARM_CMD]);
+    publishEvent(index, SIM_T_DOOR_STATUS, g.door == DOOR_OPEN ? "OPENED" : "CLOSED");
+    g.publisher.invalidate();
+  }
+
+  g.mqtt.loop();
+
+  // Simulated servo sweep finished
+  if (g.doorDoneAt != 0 && now >= g.doorDoneAt) {
+    g.doorDoneAt = 0;
+    if (g.door == DOOR_OPENING) {
+      g.door = DOOR_OPEN;
+      publishEvent(index, SIM_T_DOOR_STATUS, "OPENED");
+    } else if (g.door == DOOR_CLOSING) {
+      g.door = DOOR_CLOSED;
+      publishEvent(index, SIM_T_DOOR_STATUS, "CLOSED");
+    }
+  }
+
+  if (now - g.lastSample >= FLEET_SIM_SAMPLE_INTERVAL) {
+    g.lastSample = now;
+    stepScenario(index, now);
+    g.publisher.publishSensorData(g.data);
+  }
+}
+
+// ============================================
+// SCENARIOS
+// ============================================
+
+void FleetSimulator::stepScenario(int index, unsigned long now) {
+  SimGarage& g = garages[index];
+  unsigned long t = (now >= g.phaseStart) ? now - g.phaseStart : 0;
+
+  // Ambient baseline with a little noise
+  g.data.timestamp = now;
+  g.data.temperatureDHT = 25.0 + random(-10, 11) / 10.0;
+  g.data.humidity = 60.0 + random(-20, 21) / 10.0;
+  g.data.smokeLevel = 100 + random(-10, 11);
+  g.data.distanceOutside = MAX_DISTANCE;
+  g.data.distanceInside = 250.0;
+  g.data.pirMotion = false;
+
+  switch (g.scenario) {
+    case SIM_VEHICLE_ARRIVAL:
+      if (g.door == DOOR_OPEN) {
+        g.data.distanceInside = 60.0;           // parked
+      } else {
+        g.data.distanceOutside = max(40.0, 300.0 - t * 0.05);  // 50 cm/s
+      }
+      if (g.data.distanceOutside < VEHICLE_DETECT_DISTANCE && !g.vehicleReported) {
+        g.vehicleReported = true;
+        publishEvent(index, SIM_T_VEHICLE, "true");
+      }
+      break;
+
+    case SIM_FIRE:
+      g.data.temperatureDHT = min(80.0, 30.0 + t * 0.002);   // +2 °C/s
+      g.data.smokeLevel = min(950UL, 200 + t / 25);
+      if ((g.data.temperatureDHT > TEMP_CRITICAL_THRESHOLD ||
+           g.data.smokeLevel > SMOKE_CRITICAL_THRESHOLD) && g.alarm != ALARM_FIRE) {
+        g.alarm = ALARM_FIRE;
+        publishEvent(index, SIM_T_ALARM_STATUS, "FIRE_DETECTED");
+      }
+      break;
+
+    case SIM_INTRUSION:
+      g.data.pirMotion = true;
+      if (g.door == DOOR_CLOSED && g.alarm != ALARM_INTRUSION) {
+        g.alarm = ALARM_INTRUSION;
+        publishEvent(index, SIM_T_ALARM_STATUS, "INTRUSION_DETECTED");
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  if (t < FLEET_SIM_PHASE_MS) return;
+
+  // Phase over - clear state and pick the next scenario
+  if (g.alarm == ALARM_FIRE || g.alarm == ALARM_INTRUSION) {
+    g.alarm = ALARM_OFF;
+    publishEvent(index, SIM_T_ALARM_STATUS, "OFF");
+  }
+  if (g.vehicleReported) {
+    g.vehicleReported = false;
+    publishEvent(index, SIM_T_VEHICLE, "false");
+  }
+
+  long r = random(100);
+  if (r < 50)      g.scenario = SIM_IDLE;
+  else if (r < 80) g.scenario = SIM_VEHICLE_ARRIVAL;
+  else if (r < 90) g.scenario = SIM_FIRE;
+  else             g.scenario = SIM_INTRUSION;
+  g.phaseStart = now;
+}
+
+void FleetSimulator::publishEvent(int index, SimTopic topic, const char* payload) {
+  if (garages[index].mqtt.publish(garages[index].topics[topic], payload)) {
+    stats.published++;
+  }
+}
+
+// ============================================
+// GARAGE SIDE - same semantics as mqttCallback()
+// ============================================
+
+void FleetSimulator::onGarageMessage(int index, const char* topic,
+                                     const byte* payload, unsigned int length) {
+  SimGarage& g = garages[index];
+
+  char message[16];
+  unsigned int n = min(length, (unsigned int)sizeof(message) - 1);
+  memcpy(message, payload, n);
+  message[n] = '\0';
+
+  if (strcmp(topic, g.topics[SIM_T_DOOR_CMD]) == 0) {
+    if (strcmp(message, "OPEN") == 0 && g.door != DOOR_OPEN) {
+      g.door = DOOR_OPENING;
+      g.doorDoneAt = millis() + FLEET_SIM_SERVO_MS;
+    } else if (strcmp(message, "CLOSE") == 0 && g.door != DOOR_CLOSED) {
+      g.door = DOOR_CLOSING;
+      g.doorDoneAt = millis() + FLEET_SIM_SERVO_MS;
+    }
+  } else if (strcmp(topic, g.topics[SIM_T_ALARM_CMD]) == 0) {
+    if (strcmp(message, "ON") == 0) {
+      g.alarm = ALARM_ON;
+      publishEvent(index, SIM_T_ALARM_STATUS, "ON");
+    } else if (strcmp(message, "OFF") == 0) {
+      g.alarm = ALARM_OFF;
+      publishEvent(index, SIM_T_ALARM_STATUS, "OFF");
+    }
+  }
+}
+
+// ============================================
+// OPERATOR SIDE
+// ============================================
+
+int FleetSimulator::garageFromTopic(const char* topic) {
+  int index;
+  if (sscanf(topic, "sim%3d/", &index) != 1) return -1;
+  return (index >= 0 && index < garageCount) ? index : -1;
+}
+
+void FleetSimulator::sendCommand(int index, const char* command) {
+  if (!controller.connected()) return;
+  if (controller.publish(garages[index].topics[SIM_T_DOOR_CMD], command)) {
+    commandSentAt[index] = millis();
+    stats.commandsSent++;
+  }
+}
+
+void FleetSimulator::onControllerMessage(const char* topic, const byte* payload,
+                                         unsigned int length) {
+  int index = garageFromTopic(topic);
+  if (index < 0) return;
+
+  char message[16];
+  unsigned int n = min(length, (unsigned int)sizeof(message) - 1);
+  memcpy(message, payload, n);
+  message[n] = '\0';
+
+  unsigned long now = millis();
+
+  if (strcmp(topic, garages[index].topics[SIM_T_VEHICLE]) == 0) {
+    if (strcmp(message, "true") == 0) sendCommand(index, "OPEN");
+    return;
+  }
+
+  // Door status answers a pending command
+  if (commandSentAt[index] == 0) return;
+
+  if (strcmp(message, "OPENED") == 0) {
+    closeDueAt[index] = now + FLEET_SIM_DOOR_HOLD;
+  } else if (strcmp(message, "CLOSED") != 0) {
+    return;
+  }
+
+  recordRtt(now - commandSentAt[index]);
+  commandSentAt[index] = 0;
+  stats.commandsAnswered++;
+}
+
+// ============================================
+// METRICS
+// ============================================
+
+void FleetSimulator::recordRtt(unsigned long ms) {
+  if (rttCount < FLEET_SIM_RTT_SAMPLES) {
+    rtt[rttCount++] = ms;
+  } else {
+    rtt[random(FLEET_SIM_RTT_SAMPLES)] = ms;  // reservoir-style replacement
+  }
+}
+
+void FleetSimulator::report(unsigned long now) {
+  unsigned long elapsed = now - lastReportTime;
+  lastReportTime = now;
+
+  unsigned long published = stats.published;
+  for (int i = 0; i < garageCount; i++) {
+    published += garages[i].publisher.getSentCount();
+  }
+  float rate = (published - lastReport.published) * 1000.0 / elapsed;
+
+  // Sort the window's RTT samples (small N - insertion sort)
+  for (int i = 1; i < rttCount; i++) {
+    unsigned long v = rtt[i];
+    int j = i - 1;
+    while (j >= 0 && rtt[j] > v) {
+      rtt[j + 1] = rtt[j];
+      j--;
+    }
+    rtt[j + 1] = v;
+  }
+  unsigned long p50 = rttCount ? rtt[(rttCount - 1) * 50 / 100] : 0;
+  unsigned long p90 = rttCount ? rtt[(rttCount - 1) * 90 / 100] : 0;
+  unsigned long p99 = rttCount ? rtt[(rttCount - 1) * 99 / 100] : 0;
+
+  int online = 0;
+  for (int i = 0; i < garageCount; i++) {
+    if (garages[i].mqtt.connected()) online++;
+  }
+
+  char json[256];
+  snprintf(json, sizeof(json),
+           "{\"garages\":%d,\"online\":%d,\"pub_per_s\":%.1f,\"cmds\":%lu,\"answered\":%lu,"
+           "\"rtt_n\":%d,\"rtt_p50\":%lu,\"rtt_p90\":%lu,\"rtt_p99\":%lu,"
+           "\"connects\":%lu,\"disconnects\":%lu,\"failures\":%lu}",
+           garageCount, online, rate, stats.commandsSent, stats.commandsAnswered,
+           rttCount, p50, p90, p99,
+           stats.connects - lastReport.connects,
+           stats.disconnects - lastReport.disconnects,
+           stats.connectFailures - lastReport.connectFailures);
+
+  // Full report is longer than a log record - print it directly
+  Serial.print("[FleetSim] ");
+  Serial.println(json);
+  if (controller.connected()) {
+    controller.publish(TOPIC_FLEET_SIM_REPORT, json);
+  }
+
+  lastReport = stats;
+  lastReport.published = published;
+  rttCount = 0;
+}
@@ -0,0 +1,129 @@
+// FleetSimulator.h
+#ifndef FLEET_SIMULATOR_H
+#define FLEET_SIMULATOR_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include "config.h"
+#include "Logger.h"
+#include "SensorModule.h"
+#include "DeadbandPublisher.h"
+
+// ============================================
+// SCENARIOS
+// ============================================
+enum SimScenario : uint8_t {
+  SIM_IDLE,
+  SIM_VEHICLE_ARRIVAL,
+  SIM_FIRE,
+  SIM_INTRUSION
+};
+
+// ============================================
+// VIRTUAL GARAGE
+// ============================================
+// One MQTT session with its own client ID and topic prefix
+// ("sim<NNN>/garage/..."). It publishes SensorData through the same
+// DeadbandPublisher as the firmware and answers door/alarm commands
+// like mqttCallback() does.
+enum SimTopic : uint8_t {
+  SIM_T_TEMPERATURE,
+  SIM_T_HUMIDITY,
+  SIM_T_SMOKE,
+  SIM_T_DISTANCE_OUT,
+  SIM_T_DISTANCE_IN,
+  SIM_T_PIR,
+  SIM_T_DOOR_CMD,
+  SIM_T_DOOR_STATUS,
+  SIM_T_ALARM_CMD,
+  SIM_T_ALARM_STATUS,
+  SIM_T_VEHICLE,
+  SIM_TOPIC_COUNT
+};
+
+struct SimGarage {
+  WiFiClient net;
+  PubSubClient mqtt;
+  DeadbandPublisher publisher;
+
+  char clientId[24];
+  char topics[SIM_TOPIC_COUNT][48];
+
+  SensorData data;
+  SimScenario scenario;
+  unsigned long phaseStart;
+  unsigned long lastSample;
+  unsigned long lastConnectAttempt;
+  unsigned long doorDoneAt;       // simulated servo sweep end, 0 = idle
+  DoorState door;
+  AlarmState alarm;
+  bool vehicleReported;
+  bool wasConnected;
+
+  SimGarage() : mqtt(net), publisher(mqtt) {}
+};
+
+struct FleetStats {
+  unsigned long published;
+  unsigned long commandsSent;
+  unsigned long commandsAnswered;
+  unsigned long connects;
+  unsigned long disconnects;
+  unsigned long connectFailures;
+};
+
+// ============================================
+// CLASS FLEET SIMULATOR
+// ============================================
+// Load generator for broker/backend capacity tests. A separate
+// controller session plays the operator: it answers every vehicle
+// arrival with OPEN (and later CLOSE) and measures the command
+// round-trip through the broker until the garage reports the new state.
+class FleetSimulator {
+private:
+  SimGarage garages[FLEET_SIM_GARAGES];
+  int garageCount;
+  const char* broker;
+  uint16_t port;
+  WiFiClient controllerNet;
+  PubSubClient controller;
+  char controllerId[24];
+
+  unsigned long commandSentAt[FLEET_SIM_GARAGES];
+  unsigned long closeDueAt[FLEET_SIM_GARAGES];
+
+  unsigned long rtt[FLEET_SIM_RTT_SAMPLES];
+  int rttCount;
+  FleetStats stats;
+  FleetStats lastReport;
+  unsigned long lastReportTime;
+  unsigned long churnInterval;
+  unsigned long lastChurn;
+  unsigned long lastControllerAttempt;
+  bool started;
+
+  void setupGarage(int index);
+  void serviceGarage(int index, unsigned long now);
+  void stepScenario(int index, unsigned long now);
+  void publishEvent(int index, SimTopic topic, const char* payload);
+  void onGarageMessage(int index, const char* topic, const byte* payload, unsigned int length);
+  void onControllerMessage(const char* topic, const byte* payload, unsigned int length);
+  void sendCommand(int index, const char* command);
+  void recordRtt(unsigned long ms);
+  int garageFromTopic(const char* topic);
+  void report(unsigned long now);
+
+public:
+  FleetSimulator();
+
+  // Runs `count` (<= FLEET_SIM_GARAGES) garages. Returns false, and
+  // stays idle, when pointed at MQTT_SERVER.
+  bool begin(const char* host = FLEET_SIM_BROKER, uint16_t hostPort = FLEET_SIM_PORT,
+             int count = FLEET_SIM_GARAGES);
+  // Drop a random garage's session every `ms` (0 = off)
+  void setChurnInterval(unsigned long ms);
+  void loop();
+};
+
+#endif
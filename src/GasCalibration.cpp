@@ -0,0 +1,189 @@
+// GasCalibration.cpp
+#include "GasCalibration.h"
+
+// ============================================
+// CURVES & TABLES (built at compile time)
+// ============================================
+// Fitted through the datasheet points at 200 ppm and the slope of each
+// line: smoke 3.39 @ 200 ppm, LPG 1.62 @ 200 ppm, CO 5.25 @ 200 ppm.
+static constexpr GasCurve GAS_CURVES[GAS_TYPE_COUNT] = {
+  { -0.44, 1.542 },   // GAS_SMOKE
+  { -0.47, 1.291 },   // GAS_LPG
+  { -0.34, 1.502 },   // GAS_CO
+};
+
+static constexpr GasLut GAS_LUTS[GAS_TYPE_COUNT] = {
+  makeGasLut(GAS_CURVES[GAS_SMOKE]),
+  makeGasLut(GAS_CURVES[GAS_LPG]),
+  makeGasLut(GAS_CURVES[GAS_CO]),
+};
+
+#define GAS_RATIO_MIN_SHIFT     (GAS_RATIO_SHIFT - GAS_LUT_OCTAVES / 2)
+
+constexpr bool gasDescending(const GasLut& lut, unsigned i) {
+  return i + 1 >= GAS_LUT_SIZE ? true
+       : lut.ppm[i] >= lut.ppm[i + 1] && gasDescending(lut, i + 1);
+}
+
+static_assert(GAS_LUT_OCTAVES % 2 == 0, "ratio range is centred on Rs/R0 = 1");
+static_assert(GAS_RATIO_MIN_SHIFT >= GAS_LUT_STEP_BITS + 8, "Q format too narrow to interpolate");
+static_assert(GAS_PPM_MAX <= 0xFFFF, "table entries are uint16_t");
+static_assert(gasDescending(GAS_LUTS[GAS_SMOKE], 0), "smoke curve must fall with Rs/R0");
+static_assert(gasDescending(GAS_LUTS[GAS_LPG], 0), "LPG curve must fall with Rs/R0");
+static_assert(gasDescending(GAS_LUTS[GAS_CO], 0), "CO curve must fall with Rs/R0");
+static_assert(GAS_LUTS[GAS_SMOKE].ppm[128] == 3196, "smoke @ Rs/R0 = 1");
+static_assert(GAS_LUTS[GAS_LPG].ppm[128] == 558, "LPG @ Rs/R0 = 1");
+static_assert(GAS_LUTS[GAS_SMOKE].ppm[0] == GAS_PPM_MAX, "table saturates at GAS_PPM_MAX");
+
+GasCalibration gasCalibration;
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+GasCalibration::GasCalibration() {
+  r0 = GAS_R0_DEFAULT;
+  calibrated = false;
+  calibrating = false;
+  calSum = 0;
+  calCount = 0;
+  calRaw = 0;
+}
+
+void GasCalibration::begin() {
+  prefs.begin("gas", true);
+  uint32_t stored = prefs.getUInt("r0", 0);
+  prefs.end();
+
+  if (stored == 0) {
+    LOG_WARN("  ⚠️ Gas sensor not calibrated, R0=%lu ohm (default)", r0);
+    return;
+  }
+
+  r0 = stored;
+  calibrated = true;
+  LOG_INFO("  ✓Gas sensor R0=%lu ohm", r0);
+}
+
+// ============================================
+// CALIBRATION
+// ============================================
+
+bool GasCalibration::startCalibration() {
+  if (calibrating) return false;
+
+  calibrating = true;
+  calSum = 0;
+  calCount = 0;
+  return true;
+}
+
+GasCalStatus GasCalibration::calibrationStep(int gasPin) {
+  if (!calibrating) return GAS_CAL_IDLE;
+
+  calSum += analogRead(gasPin);
+  calCount++;
+  if (calCount < GAS_CALIBRATION_SAMPLES) return GAS_CAL_RUNNING;
+
+  calibrating = false;
+  return finishCalibration();
+}
+
+void GasCalibration::cancelCalibration() {
+  calibrating = false;
+}
+
+GasCalStatus GasCalibration::finishCalibration() {
+  int raw = calSum / calCount;
+  calRaw = raw;
+
+  if (raw <= 0 || raw >= GAS_ADC_MAX) {
+    LOG_ERROR("❌ Gas calibration failed: ADC %d out of range", raw);
+    return GAS_CAL_FAILED;
+  }
+
+  // In clean air Rs/R0 sits at the datasheet ratio
+  uint32_t value = (uint64_t)resistance(raw) * 100 / GAS_CLEAN_AIR_RATIO_X100;
+  if (value == 0) {
+    LOG_ERROR("❌ Gas calibration failed: R0=0");
+    return GAS_CAL_FAILED;
+  }
+
+  r0 = value;
+  calibrated = true;
+
+  prefs.begin("gas", false);
+  prefs.putUInt("r0", r0);
+  prefs.end();
+
+  LOG_INFO("✓ Gas sensor calibrated: ADC %d, R0=%lu ohm", raw, r0);
+  return GAS_CAL_DONE;
+}
+
+// ============================================
+// CONVERSION
+// ============================================
+
+// Divider: Vout = Vc * RL / (RL + Rs)  =>  Rs = RL * (max - raw) / raw
+uint32_t GasCalibration::resistance(int raw) {
+  if (raw <= 0) return UINT32_MAX;
+  if (raw >= GAS_ADC_MAX) return 0;
+  return (uint32_t)GAS_LOAD_RESISTOR * (GAS_ADC_MAX - raw) / raw;
+}
+
+uint32_t GasCalibration::ratio(int raw) {
+  if (raw <= 0) return UINT32_MAX;
+  if (raw >= GAS_ADC_MAX) return 0;
+
+  uint64_t q = ((uint64_t)GAS_LOAD_RESISTOR * (GAS_ADC_MAX - raw) << GAS_RATIO_SHIFT) /
+               ((uint64_t)raw * r0);
+  return (q > UINT32_MAX) ? UINT32_MAX : (uint32_t)q;
+}
+
+uint16_t GasCalibration::ppm(int raw, GasType gas) {
+  if (gas >= GAS_TYPE_COUNT) return 0;
+  const uint16_t* lut = GAS_LUTS[gas].ppm;
+
+  uint32_t q = ratio(raw);
+  if (q < (1UL << GAS_RATIO_MIN_SHIFT)) return lut[0];
+  if (q >= (1UL << (GAS_RATIO_MIN_SHIFT + GAS_LUT_OCTAVES))) return lut[GAS_LUT_SIZE - 1];
+
+  // Octave from the leading bit, then 5 mantissa bits index, 8 interpolate
+  int octave = 31 - __builtin_clz(q);
+  uint32_t mantissa = q - (1UL << octave);
+  int index = (octave - GAS_RATIO_MIN_SHIFT) * GAS_LUT_STEPS + (mantissa >> (octave - GAS_LUT_STEP_BITS));
+  int32_t frac = (mantissa >> (octave - GAS_LUT_STEP_BITS - 8)) & 0xFF;
+
+  int32_t a = lut[index];
+  int32_t b = lut[index + 1];
+  return a + (b - a) * frac / 256;
+}
+
+// ============================================
+// UTILITIES
+// ============================================
+
+uint32_t GasCalibration::getR0() {
+  return r0;
+}
+
+bool GasCalibration::isCalibrated() {
+  return calibrated;
+}
+
+bool GasCalibration::isCalibrating() {
+  return calibrating;
+}
+
+int GasCalibration::getCalibrationAdc() {
+  return calRaw;
+}
+
+const char* GasCalibration::gasName(GasType gas) {
+  switch (gas) {
+    case GAS_SMOKE: return "smoke";
+    case GAS_LPG:   return "LPG";
+    case GAS_CO:    return "CO";
+    default:        return "unknown";
+  }
+}
@@ -0,0 +1,157 @@
+// GasCalibration.h
+#ifndef GAS_CALIBRATION_H
+#define GAS_CALIBRATION_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+#include "Logger.h"
+
+// ============================================
+// GAS CURVES (MQ-2 datasheet, log-log)
+// ============================================
+// log10(Rs/R0) = slope * log10(ppm) + intercept
+enum GasType : uint8_t {
+  GAS_SMOKE,
+  GAS_LPG,
+  GAS_CO,
+  GAS_TYPE_COUNT
+};
+
+struct GasCurve {
+  double slope;
+  double intercept;
+};
+
+// ============================================
+// LOOKUP TABLE LAYOUT
+// ============================================
+// Rs/R0 from 1/16 to 16, 32 points per octave: entry i sits at
+// 2^(i/32 - 4) * (1 + (i % 32) / 32). The octave and the first mantissa
+// bits of a fixed-point ratio give the index directly, the next bits
+// interpolate - no pow()/log() at runtime.
+#define GAS_LUT_OCTAVES         8
+#define GAS_LUT_STEP_BITS       5
+#define GAS_LUT_STEPS           (1 << GAS_LUT_STEP_BITS)   // per octave
+#define GAS_LUT_SIZE            (GAS_LUT_OCTAVES * GAS_LUT_STEPS + 1)
+#define GAS_RATIO_SHIFT         20     // Rs/R0 in Q20
+
+struct GasLut {
+  uint16_t ppm[GAS_LUT_SIZE];
+};
+
+// ============================================
+// COMPILE-TIME MATH (C++11 constexpr)
+// ============================================
+#define GAS_LN2                 0.69314718055994531
+#define GAS_LN10                2.30258509299404568
+
+// ln(x) for x in [1, 2): 2 * atanh((x - 1) / (x + 1))
+constexpr double gasAtanhSeries(double power, double zz, int n) {
+  return n > 31 ? 0 : power / n + gasAtanhSeries(power * zz, zz, n + 2);
+}
+
+constexpr double gasLnMantissa(double z) {
+  return 2 * gasAtanhSeries(z, z * z, 1);
+}
+
+// exp(y) = exp(y / 32)^32
+constexpr double gasExpTaylor(double x, double term, int n) {
+  return n > 20 ? term : term + gasExpTaylor(x, term * x / n, n + 1);
+}
+
+constexpr double gasSquare(double v, int times) {
+  return times == 0 ? v : gasSquare(v * v, times - 1);
+}
+
+constexpr double gasExp(double y) {
+  return gasSquare(gasExpTaylor(y / 32, 1, 1), 5);
+}
+
+constexpr double gasLnRatio(unsigned i) {
+  return ((int)(i / GAS_LUT_STEPS) - GAS_LUT_OCTAVES / 2) * GAS_LN2 +
+         gasLnMantissa((double)(i % GAS_LUT_STEPS) / (2 * GAS_LUT_STEPS + (i % GAS_LUT_STEPS)));
+}
+
+constexpr uint16_t gasClampPpm(double ppm) {
+  return ppm >= GAS_PPM_MAX ? GAS_PPM_MAX : (uint16_t)(ppm + 0.5);
+}
+
+// ppm = 10^((log10(ratio) - intercept) / slope)
+constexpr uint16_t gasPpmAt(const GasCurve& c, unsigned i) {
+  return gasClampPpm(gasExp((gasLnRatio(i) - c.intercept * GAS_LN10) / c.slope));
+}
+
+template <unsigned... I> struct GasIndices {};
+template <unsigned N, unsigned... I> struct GasBuild : GasBuild<N - 1, N - 1, I...> {};
+template <unsigned... I> struct GasBuild<0, I...> { typedef GasIndices<I...> type; };
+
+template <unsigned... I>
+constexpr GasLut makeGasLut(const GasCurve& c, GasIndices<I...>) {
+  return GasLut{ { gasPpmAt(c, I)... } };
+}
+
+constexpr GasLut makeGasLut(const GasCurve& c) {
+  return makeGasLut(c, GasBuild<GAS_LUT_SIZE>::type());
+}
+
+enum GasCalStatus : uint8_t {
+  GAS_CAL_IDLE,
+  GAS_CAL_RUNNING,
+  GAS_CAL_DONE,
+  GAS_CAL_FAILED
+};
+
+// ============================================
+// CLASS GAS CALIBRATION
+// ============================================
+// R0 (sensor resistance in clean air) is measured once on site and kept
+// in NVS; until then GAS_R0_DEFAULT is used and readings are flagged.
+class GasCalibration {
+private:
+  Preferences prefs;
+  uint32_t r0;
+  bool calibrated;
+
+  // Calibration run in progress
+  bool calibrating;
+  uint32_t calSum;
+  uint16_t calCount;
+  int calRaw;                   // average ADC of the last run
+
+  GasCalStatus finishCalibration();
+
+public:
+  GasCalibration();
+
+  // Load R0 from NVS
+  void begin();
+
+  // Calibration in clean air without blocking: startCalibration(), then
+  // calibrationStep() every GAS_CALIBRATION_INTERVAL ms. Each step takes
+  // one ADC reading; after GAS_CALIBRATION_SAMPLES the average sets R0
+  // (stored in NVS) and the step returns GAS_CAL_DONE or GAS_CAL_FAILED.
+  bool startCalibration();
+  GasCalStatus calibrationStep(int gasPin);
+  void cancelCalibration();
+  bool isCalibrating();
+  int getCalibrationAdc();
+
+  // Sensor resistance (ohms) for a raw ADC reading
+  static uint32_t resistance(int raw);
+
+  // Rs/R0 in Q20
+  uint32_t ratio(int raw);
+
+  // O(1): integer ratio, table index + linear interpolation
+  uint16_t ppm(int raw, GasType gas = GAS_SMOKE);
+
+  uint32_t getR0();
+  bool isCalibrated();
+
+  static const char* gasName(GasType gas);
+};
+
+extern GasCalibration gasCalibration;
+
+#endif
@@ -0,0 +1,227 @@
+// HistoryStore.cpp
+#include "HistoryStore.h"
+
+static const char* const CHANNEL_NAMES[HIST_CHANNEL_COUNT] = {
+  "temp", "hum", "smoke", "out", "in", "pir"
+};
+
+static const char LEVEL_CODES[] = { 'r', 'm', 'h' };
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+HistoryStore::HistoryStore() {
+  hasOpenBuckets = false;
+  memset(&stats, 0, sizeof(stats));
+}
+
+// ============================================
+// APPEND
+// ============================================
+
+float HistoryStore::channelValue(const SensorData& data, HistoryChannel channel) {
+  switch (channel) {
+    case HIST_TEMPERATURE:  return data.temperatureDHT;
+    case HIST_HUMIDITY:     return data.humidity;
+    case HIST_SMOKE:        return data.smokeLevel;
+    case HIST_DISTANCE_OUT: return data.distanceOutside;
+    case HIST_DISTANCE_IN:  return data.distanceInside;
+    case HIST_PIR:          return data.pirMotion ? 1.0 : 0.0;
+    default:                return NAN;
+  }
+}
+
+void HistoryStore::resetBucket(HistoryRollup& bucket, unsigned long start) {
+  bucket.start = start;
+  for (int c = 0; c < HIST_CHANNEL_COUNT; c++) {
+    bucket.minV[c] = 0;
+    bucket.maxV[c] = 0;
+    bucket.sum[c] = 0;
+    bucket.count[c] = 0;
+  }
+}
+
+void HistoryStore::accumulate(HistoryRollup& bucket, const SensorData& data) {
+  for (int c = 0; c < HIST_CHANNEL_COUNT; c++) {
+    float v = channelValue(data, (HistoryChannel)c);
+    if (isnan(v)) continue;
+
+    if (bucket.count[c] == 0 || v < bucket.minV[c]) bucket.minV[c] = v;
+    if (bucket.count[c] == 0 || v > bucket.maxV[c]) bucket.maxV[c] = v;
+    bucket.sum[c] += v;
+    bucket.count[c]++;
+  }
+}
+
+void HistoryStore::append(const SensorData& data) {
+  unsigned long start = micros();
+  unsigned long t = data.timestamp;
+
+  raw.push(packSensorData(data));
+
+  unsigned long minuteStart = t - (t % 60000UL);
+  unsigned long hourStart = t - (t % 3600000UL);
+
+  if (!hasOpenBuckets) {
+    resetBucket(openMinute, minuteStart);
+    resetBucket(openHour, hourStart);
+    hasOpenBuckets = true;
+  }
+
+  // Close buckets whose period has ended
+  if (openMinute.start != minuteStart) {
+    minutes.push(openMinute);
+    resetBucket(openMinute, minuteStart);
+  }
+  if (openHour.start != hourStart) {
+    hours.push(openHour);
+    resetBucket(openHour, hourStart);
+  }
+
+  accumulate(openMinute, data);
+  accumulate(openHour, data);
+
+  unsigned long elapsed = micros() - start;
+  stats.appendCount++;
+  stats.lastAppendMicros = elapsed;
+  if (elapsed > stats.maxAppendMicros) stats.maxAppendMicros = elapsed;
+}
+
+// ============================================
+// ENTRY ACCESS
+// ============================================
+
+int HistoryStore::levelSize(HistoryLevel level) {
+  switch (level) {
+    case HIST_LEVEL_RAW:    return raw.count;
+    case HIST_LEVEL_MINUTE: return hasOpenBuckets ? minutes.count + 1 : 0;
+    case HIST_LEVEL_HOUR:   return hasOpenBuckets ? hours.count + 1 : 0;
+    default:                return 0;
+  }
+}
+
+const HistoryRollup* HistoryStore::rollupAt(HistoryLevel level, int index) {
+  if (level == HIST_LEVEL_MINUTE) {
+    return (index == 0) ? &openMinute : &minutes.fromNewest(index - 1);
+  }
+  return (index == 0) ? &openHour : &hours.fromNewest(index - 1);
+}
+
+unsigned long HistoryStore::entryTime(HistoryLevel level, int index) {
+  if (level == HIST_LEVEL_RAW) return raw.fromNewest(index).timestamp;
+  return rollupAt(level, index)->start;
+}
+
+int HistoryStore::findRange(const HistoryQuery& query, unsigned long now, int& newest) {
+  int size = levelSize(query.level);
+  int rows = 0;
+  newest = -1;
+
+  // Ages grow with the index, so the range is one contiguous run
+  for (int i = 0; i < size; i++) {
+    unsigned long age = now - entryTime(query.level, i);
+    if (age < query.toAge) continue;
+    if (age > query.fromAge) break;
+    if (newest < 0) newest = i;
+    rows++;
+  }
+  return rows;
+}
+
+// ============================================
+// QUERY
+// ============================================
+
+bool HistoryStore::parseQuery(const String& payload, HistoryQuery& query) {
+  int c1 = payload.indexOf(',');
+  if (c1 != 1) return false;
+  int c2 = payload.indexOf(',', c1 + 1);
+  if (c2 < 0) return false;
+  int c3 = payload.indexOf(',', c2 + 1);
+
+  switch (payload.charAt(0)) {
+    case 'r': query.level = HIST_LEVEL_RAW; break;
+    case 'm': query.level = HIST_LEVEL_MINUTE; break;
+    case 'h': query.level = HIST_LEVEL_HOUR; break;
+    default:  return false;
+  }
+
+  String channel = payload.substring(c1 + 1, c2);
+  int found = -1;
+  for (int c = 0; c < HIST_CHANNEL_COUNT; c++) {
+    if (channel == CHANNEL_NAMES[c]) found = c;
+  }
+  if (found < 0) return false;
+  query.channel = (HistoryChannel)found;
+
+  String from = (c3 < 0) ? payload.substring(c2 + 1) : payload.substring(c2 + 1, c3);
+  query.fromAge = (unsigned long)from.toInt() * 1000UL;
+  query.toAge = (c3 < 0) ? 0 : (unsigned long)payload.substring(c3 + 1).toInt() * 1000UL;
+
+  return query.fromAge >= query.toAge;
+}
+
+int HistoryStore::replyParts(const HistoryQuery& query) {
+  int newest;
+  int rows = findRange(query, millis(), newest);
+  return (rows == 0) ? 1 : (rows + HISTORY_REPLY_ROWS - 1) / HISTORY_REPLY_ROWS;
+}
+
+size_t HistoryStore::encodeReply(const HistoryQuery& query, int part, char* buf, size_t len) {
+  unsigned long start = micros();
+  unsigned long now = millis();
+
+  int newest;
+  int rows = findRange(query, now, newest);
+  int parts = (rows == 0) ? 1 : (rows + HISTORY_REPLY_ROWS - 1) / HISTORY_REPLY_ROWS;
+  if (part < 0 || part >= parts) return 0;
+
+  int c = query.channel;
+  int n = snprintf(buf, len, "%c,%s,%d/%d",
+                   LEVEL_CODES[query.level], CHANNEL_NAMES[c], part + 1, parts);
+
+  // Rows are emitted oldest first
+  int first = part * HISTORY_REPLY_ROWS;
+  int last = min(rows, first + HISTORY_REPLY_ROWS);
+
+  for (int r = first; r < last && n > 0 && (size_t)n < len; r++) {
+    int index = newest + (rows - 1 - r);
+    unsigned long age = (now - entryTime(query.level, index)) / 1000UL;
+
+    if (query.level == HIST_LEVEL_RAW) {
+      float v = channelValue(unpackSensorData(raw.fromNewest(index)), query.channel);
+      n += snprintf(buf + n, len - n, ";%lu,%.1f", age, v);
+    } else {
+      const HistoryRollup* b = rollupAt(query.level, index);
+      if (b->count[c] == 0) {
+        n += snprintf(buf + n, len - n, ";%lu,,,", age);
+      } else {
+        n += snprintf(buf + n, len - n, ";%lu,%.1f,%.1f,%.1f", age,
+                      b->minV[c], b->maxV[c], b->sum[c] / b->count[c]);
+      }
+    }
+  }
+
+  unsigned long elapsed = micros() - start;
+  stats.queryCount++;
+  stats.lastQueryMicros = elapsed;
+  if (elapsed > stats.maxQueryMicros) stats.maxQueryMicros = elapsed;
+
+  if (n <= 0 || (size_t)n >= len) return 0;  // truncated
+  return n;
+}
+
+// ============================================
+// UTILITIES
+// ============================================
+
+const HistoryStats& HistoryStore::getStats() {
+  return stats;
+}
+
+void HistoryStore::printStats() {
+  LOG_INFO("[History] raw=%d minutes=%d hours=%d append max=%luus query max=%luus",
+           raw.count, minutes.count, hours.count,
+           stats.maxAppendMicros, stats.maxQueryMicros);
+}
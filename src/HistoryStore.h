@@ -0,0 +1,132 @@
+// HistoryStore.h
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "Logger.h"
+#include "SensorModule.h"
+#include "PackedSample.h"
+
+// ============================================
+// CHANNELS & LEVELS
+// ============================================
+enum HistoryChannel : uint8_t {
+  HIST_TEMPERATURE,
+  HIST_HUMIDITY,
+  HIST_SMOKE,
+  HIST_DISTANCE_OUT,
+  HIST_DISTANCE_IN,
+  HIST_PIR,
+  HIST_CHANNEL_COUNT
+};
+
+enum HistoryLevel : uint8_t {
+  HIST_LEVEL_RAW,
+  HIST_LEVEL_MINUTE,
+  HIST_LEVEL_HOUR
+};
+
+// ============================================
+// ROLLUP BUCKET
+// ============================================
+struct HistoryRollup {
+  unsigned long start;                     // millis() of bucket start
+  float minV[HIST_CHANNEL_COUNT];
+  float maxV[HIST_CHANNEL_COUNT];
+  float sum[HIST_CHANNEL_COUNT];
+  uint16_t count[HIST_CHANNEL_COUNT];      // NaN samples are skipped
+};
+
+// ============================================
+// FIXED-CAPACITY RING
+// ============================================
+template <typename T, int N>
+struct HistoryRing {
+  T items[N];
+  int head = 0;    // next write position
+  int count = 0;
+
+  void push(const T& item) {
+    items[head] = item;
+    head = (head + 1) % N;
+    if (count < N) count++;
+  }
+
+  // 0 = newest
+  const T& fromNewest(int i) const {
+    return items[(head - 1 - i + N) % N];
+  }
+};
+
+// ============================================
+// QUERY
+// ============================================
+// MQTT payload: "<level>,<channel>,<from_s>[,<to_s>]"
+//   level   r | m | h
+//   channel temp | hum | smoke | out | in | pir
+//   from_s  oldest sample age in seconds
+//   to_s    newest sample age in seconds (default 0)
+// Example: "m,temp,3600" = last hour of 1-minute temperature rollups.
+struct HistoryQuery {
+  HistoryLevel level;
+  HistoryChannel channel;
+  unsigned long fromAge;   // ms
+  unsigned long toAge;     // ms
+};
+
+struct HistoryStats {
+  unsigned long appendCount;
+  unsigned long lastAppendMicros;
+  unsigned long maxAppendMicros;
+  unsigned long queryCount;
+  unsigned long lastQueryMicros;
+  unsigned long maxQueryMicros;
+};
+
+// ============================================
+// CLASS HISTORY STORE
+// ============================================
+class HistoryStore {
+private:
+  HistoryRing<PackedSample, HISTORY_RAW_SIZE> raw;   // 12 B per sample
+  HistoryRing<HistoryRollup, HISTORY_MINUTE_SIZE> minutes;
+  HistoryRing<HistoryRollup, HISTORY_HOUR_SIZE> hours;
+  HistoryRollup openMinute;
+  HistoryRollup openHour;
+  bool hasOpenBuckets;
+  HistoryStats stats;
+
+  static void resetBucket(HistoryRollup& bucket, unsigned long start);
+  static void accumulate(HistoryRollup& bucket, const SensorData& data);
+
+  // Entries are addressed newest-first; for rollup levels index 0 is the
+  // bucket still being filled.
+  int levelSize(HistoryLevel level);
+  unsigned long entryTime(HistoryLevel level, int index);
+  const HistoryRollup* rollupAt(HistoryLevel level, int index);
+
+  // Locate the query range. Returns the row count and the newest index.
+  int findRange(const HistoryQuery& query, unsigned long now, int& newest);
+
+public:
+  HistoryStore();
+
+  void append(const SensorData& data);
+
+  static bool parseQuery(const String& payload, HistoryQuery& query);
+  static float channelValue(const SensorData& data, HistoryChannel channel);
+
+  // Number of reply messages needed for the query
+  int replyParts(const HistoryQuery& query);
+
+  // Encode reply part into buf:
+  //   "<level>,<channel>,<part>/<parts>;<age_s>,<min>,<max>,<avg>;..."
+  // Raw rows are "<age_s>,<value>". Returns bytes written, 0 on error.
+  size_t encodeReply(const HistoryQuery& query, int part, char* buf, size_t len);
+
+  const HistoryStats& getStats();
+  void printStats();
+};
+
+#endif
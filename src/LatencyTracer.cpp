@@ -0,0 +1,217 @@
+// LatencyTracer.cpp
+#include "LatencyTracer.h"
+
+static_assert(TRACE_MAX_ACTIVE < 255, "TraceId is slot + 1 in a uint8_t");
+static_assert(TRACE_HOP_COUNT <= 8, "hopMask is 8 bits wide");
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+LatencyTracer::LatencyTracer(PubSubClient& mqtt) : client(mqtt) {
+  memset(slots, 0, sizeof(slots));
+  memset(kindStats, 0, sizeof(kindStats));
+  fireCount = 0;
+}
+
+String LatencyTracer::splitCorrelationId(String& payload) {
+  int sep = payload.indexOf('#');
+  if (sep < 0) return "";
+
+  String id = payload.substring(sep + 1);
+  payload = payload.substring(0, sep);
+  if (id.length() >= TRACE_ID_SIZE) id = id.substring(0, TRACE_ID_SIZE - 1);
+  return id;
+}
+
+// ============================================
+// TRACE LIFECYCLE
+// ============================================
+
+TraceSlot* LatencyTracer::slotOf(TraceId trace) {
+  if (trace == TRACE_NONE || trace > TRACE_MAX_ACTIVE) return nullptr;
+  TraceSlot* slot = &slots[trace - 1];
+  return slot->active ? slot : nullptr;
+}
+
+TraceId LatencyTracer::begin(TraceKind kind, const char* id, uint8_t bay, unsigned long startMicros) {
+  if (id == nullptr || id[0] == '\0') return TRACE_NONE;
+
+  for (uint8_t i = 0; i < TRACE_MAX_ACTIVE; i++) {
+    TraceSlot& slot = slots[i];
+    if (slot.active) continue;
+
+    strlcpy(slot.id, id, TRACE_ID_SIZE);
+    slot.kind = kind;
+    slot.bay = bay;
+    slot.active = true;
+    slot.hopMask = 1 << TRACE_RECEIVED;
+    slot.hopMicros[TRACE_RECEIVED] = startMicros;
+    return i + 1;
+  }
+
+  LOG_WARN("[Trace] No free slot for %s", logCopy(id));
+  return TRACE_NONE;
+}
+
+TraceId LatencyTracer::beginFire(unsigned long startMicros) {
+  if (!TRACE_FIRE_ALERTS) return TRACE_NONE;
+
+  char id[TRACE_ID_SIZE];
+  snprintf(id, sizeof(id), "fire-%lu", ++fireCount);
+  return begin(TRACE_FIRE_ALERT, id, 0, startMicros);
+}
+
+void LatencyTracer::mark(TraceId trace, TraceHop hop) {
+  mark(trace, hop, micros());
+}
+
+void LatencyTracer::mark(TraceId trace, TraceHop hop, unsigned long atMicros) {
+  TraceSlot* slot = slotOf(trace);
+  if (slot == nullptr || (slot->hopMask & (1 << hop))) return;
+
+  slot->hopMicros[hop] = atMicros;
+  slot->hopMask |= 1 << hop;
+}
+
+void LatencyTracer::finish(TraceId trace) {
+  TraceSlot* slot = slotOf(trace);
+  if (slot == nullptr) return;
+
+  mark(trace, TRACE_DELIVERED);
+
+  unsigned long total = slot->hopMicros[TRACE_DELIVERED] - slot->hopMicros[TRACE_RECEIVED];
+  record(slot->kind, total);
+  publishBreakdown(*slot);
+
+  LOG_INFO("[Trace] %s %s bay %u: %.1f ms", logCopy(slot->id),
+           kindName(slot->kind), slot->bay, total / 1000.0);
+  slot->active = false;
+}
+
+void LatencyTracer::abandon(TraceId trace) {
+  TraceSlot* slot = slotOf(trace);
+  if (slot == nullptr) return;
+
+  kindStats[slot->kind].abandoned++;
+  slot->active = false;
+}
+
+void LatencyTracer::expire() {
+  unsigned long now = micros();
+
+  for (uint8_t i = 0; i < TRACE_MAX_ACTIVE; i++) {
+    TraceSlot& slot = slots[i];
+    if (!slot.active) continue;
+
+    if (now - slot.hopMicros[TRACE_RECEIVED] > TRACE_TIMEOUT * 1000UL) {
+      LOG_WARN("[Trace] %s timed out", logCopy(slot.id));
+      abandon(i + 1);
+    }
+  }
+}
+
+const char* LatencyTracer::idOf(TraceId trace) {
+  TraceSlot* slot = slotOf(trace);
+  return slot ? slot->id : "";
+}
+
+// ============================================
+// REPORTING
+// ============================================
+
+// {"id":"a1b2","kind":"door_open","bay":0,"total_us":612345,
+//  "hops":{"accepted":120,"act_start":8100,...}}   (us after "received")
+void LatencyTracer::publishBreakdown(const TraceSlot& slot) {
+  if (!client.connected()) return;
+
+  char json[320];
+  unsigned long start = slot.hopMicros[TRACE_RECEIVED];
+  int n = snprintf(json, sizeof(json),
+                   "{\"id\":\"%s\",\"kind\":\"%s\",\"bay\":%u,\"total_us\":%lu,\"hops\":{",
+                   slot.id, kindName(slot.kind), slot.bay,
+                   slot.hopMicros[TRACE_DELIVERED] - start);
+
+  bool first = true;
+  for (uint8_t h = TRACE_RECEIVED + 1; h < TRACE_HOP_COUNT && n < (int)sizeof(json); h++) {
+    if (!(slot.hopMask & (1 << h))) continue;
+    n += snprintf(json + n, sizeof(json) - n, "%s\"%s\":%lu", first ? "" : ",",
+                  hopName((TraceHop)h), slot.hopMicros[h] - start);
+    first = false;
+  }
+  if (n < (int)sizeof(json)) snprintf(json + n, sizeof(json) - n, "}}");
+
+  client.publish(TOPIC_DIAG_LATENCY, json);
+}
+
+void LatencyTracer::record(TraceKind kind, unsigned long total) {
+  TraceKindStats& ks = kindStats[kind];
+  ks.totals[ks.head] = total;
+  ks.head = (ks.head + 1) % TRACE_SAMPLES;
+  if (ks.count < TRACE_SAMPLES) ks.count++;
+  ks.completed++;
+}
+
+// Nearest-rank percentile over the recent window
+unsigned long LatencyTracer::percentile(TraceKind kind, uint8_t pct) {
+  const TraceKindStats& ks = kindStats[kind];
+  if (ks.count == 0) return 0;
+
+  unsigned long sorted[TRACE_SAMPLES];
+  for (uint8_t i = 0; i < ks.count; i++) {
+    unsigned long v = ks.totals[i];
+    int j = i - 1;
+    while (j >= 0 && sorted[j] > v) {
+      sorted[j + 1] = sorted[j];
+      j--;
+    }
+    sorted[j + 1] = v;
+  }
+
+  int rank = (pct * ks.count + 99) / 100;
+  return sorted[(rank > 0 ? rank : 1) - 1];
+}
+
+void LatencyTracer::printStats() {
+  for (uint8_t k = 0; k < TRACE_KIND_COUNT; k++) {
+    const TraceKindStats& ks = kindStats[k];
+    if (ks.completed == 0 && ks.abandoned == 0) continue;
+
+    float p50 = percentile((TraceKind)k, 50) / 1000.0;
+    float p90 = percentile((TraceKind)k, 90) / 1000.0;
+    float p99 = percentile((TraceKind)k, 99) / 1000.0;
+
+    LOG_INFO("[Trace] %s: n=%lu abandoned=%lu p50=%.1fms p90=%.1fms p99=%.1fms",
+             kindName((TraceKind)k), ks.completed, ks.abandoned, p50, p90, p99);
+
+    if (client.connected()) {
+      char json[160];
+      snprintf(json, sizeof(json),
+               "{\"kind\":\"%s\",\"n\":%lu,\"window\":%u,\"abandoned\":%lu,"
+               "\"p50_ms\":%.1f,\"p90_ms\":%.1f,\"p99_ms\":%.1f}",
+               kindName((TraceKind)k), ks.completed, ks.count, ks.abandoned, p50, p90, p99);
+      client.publish(TOPIC_DIAG_LATENCY_SUMMARY, json);
+    }
+  }
+}
+
+const char* LatencyTracer::kindName(TraceKind kind) {
+  switch (kind) {
+    case TRACE_DOOR_OPEN:  return "door_open";
+    case TRACE_DOOR_CLOSE: return "door_close";
+    case TRACE_FIRE_ALERT: return "fire_alert";
+    default:               return "unknown";
+  }
+}
+
+const char* LatencyTracer::hopName(TraceHop hop) {
+  switch (hop) {
+    case TRACE_RECEIVED:        return "received";
+    case TRACE_ACCEPTED:        return "accepted";
+    case TRACE_ACTUATION_START: return "act_start";
+    case TRACE_ACTUATION_DONE:  return "act_done";
+    case TRACE_EVENT_QUEUED:    return "queued";
+    case TRACE_DELIVERED:       return "delivered";
+    default:                    return "?";
+  }
+}
@@ -0,0 +1,101 @@
+// LatencyTracer.h
+#ifndef LATENCY_TRACER_H
+#define LATENCY_TRACER_H
+
+#include <Arduino.h>
+#include <PubSubClient.h>
+#include "config.h"
+#include "Logger.h"
+
+// ============================================
+// TRACE KINDS & HOPS
+// ============================================
+enum TraceKind : uint8_t {
+  TRACE_DOOR_OPEN,
+  TRACE_DOOR_CLOSE,
+  TRACE_FIRE_ALERT,
+  TRACE_KIND_COUNT
+};
+
+// Door:  received -> accepted -> act_start -> act_done -> queued -> delivered (status published)
+// Fire:  received (sample taken) -> queued -> act_start (extinguisher) -> delivered (Pushsafer sent)
+enum TraceHop : uint8_t {
+  TRACE_RECEIVED,
+  TRACE_ACCEPTED,
+  TRACE_ACTUATION_START,
+  TRACE_ACTUATION_DONE,
+  TRACE_EVENT_QUEUED,
+  TRACE_DELIVERED,
+  TRACE_HOP_COUNT
+};
+
+typedef uint8_t TraceId;        // slot + 1, 0 = not traced
+#define TRACE_NONE 0
+
+struct TraceSlot {
+  char id[TRACE_ID_SIZE];       // correlation ID from the payload
+  TraceKind kind;
+  uint8_t bay;
+  uint8_t hopMask;
+  bool active;
+  unsigned long hopMicros[TRACE_HOP_COUNT];
+};
+
+struct TraceKindStats {
+  unsigned long completed;
+  unsigned long abandoned;      // superseded or timed out
+  unsigned long totals[TRACE_SAMPLES];   // us, ring of recent totals
+  uint8_t head;
+  uint8_t count;
+};
+
+// ============================================
+// CLASS LATENCY TRACER
+// ============================================
+// Commands may carry a correlation ID ("OPEN#a1b2", "OPEN:1#a1b2"). The
+// ID opens a trace slot; its TraceId then rides along in Events so every
+// hop can stamp micros(). A finished trace publishes its breakdown to
+// TOPIC_DIAG_LATENCY and feeds the per-kind percentile window.
+class LatencyTracer {
+private:
+  PubSubClient& client;
+  TraceSlot slots[TRACE_MAX_ACTIVE];
+  TraceKindStats kindStats[TRACE_KIND_COUNT];
+  unsigned long fireCount;
+
+  TraceSlot* slotOf(TraceId trace);
+  void record(TraceKind kind, unsigned long total);
+  void publishBreakdown(const TraceSlot& slot);
+  unsigned long percentile(TraceKind kind, uint8_t pct);
+
+public:
+  LatencyTracer(PubSubClient& mqtt);
+
+  // Split "<command>#<id>" in place; returns the ID ("" if untraced)
+  static String splitCorrelationId(String& payload);
+
+  // Start a trace at `startMicros` (already counts as TRACE_RECEIVED)
+  TraceId begin(TraceKind kind, const char* id, uint8_t bay, unsigned long startMicros);
+  TraceId beginFire(unsigned long startMicros);
+
+  // Stamp a hop once; later marks of the same hop are ignored
+  void mark(TraceId trace, TraceHop hop);
+  void mark(TraceId trace, TraceHop hop, unsigned long atMicros);   // taken on another task
+
+  // Stamp TRACE_DELIVERED, publish the breakdown and free the slot
+  void finish(TraceId trace);
+  void abandon(TraceId trace);
+
+  // Drop traces older than TRACE_TIMEOUT
+  void expire();
+
+  const char* idOf(TraceId trace);
+
+  // p50/p90/p99 per kind, to the log and TOPIC_DIAG_LATENCY_SUMMARY
+  void printStats();
+
+  static const char* kindName(TraceKind kind);
+  static const char* hopName(TraceHop hop);
+};
+
+#endif
@@ -0,0 +1,238 @@
+// Logger.cpp
+#include "Logger.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE must be a power of two");
+static_assert(LOG_MAX_ARGS * 3 <= 32, "argument types are packed into 32 bits");
+
+static const char LEVEL_CHARS[] = { '-', 'E', 'W', 'I', 'D' };
+
+Logger logger;
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+Logger::Logger() {
+  for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+    ring[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  enqueuePos.store(0, std::memory_order_relaxed);
+  dropped.store(0, std::memory_order_relaxed);
+  written.store(0, std::memory_order_relaxed);
+  dequeuePos = 0;
+  reportedDrops = 0;
+  printed = 0;
+  highWater = 0;
+  started = false;
+}
+
+void Logger::begin() {
+  if (started) return;
+  started = true;
+
+  xTaskCreate(taskEntry, "log", LOG_TASK_STACK, this, LOG_TASK_PRIORITY, nullptr);
+}
+
+void Logger::taskEntry(void* param) {
+  Logger* self = (Logger*)param;
+
+  for (;;) {
+    if (self->drain() == 0) {
+      vTaskDelay(pdMS_TO_TICKS(LOG_IDLE_DELAY));
+    }
+  }
+}
+
+// ============================================
+// PRODUCER
+// ============================================
+
+void Logger::push(uint8_t level, const char* format, const LogArg* args, uint8_t argc) {
+  uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+  LogRecord* record;
+
+  // Claim a slot: its sequence equals pos while it is free for this lap
+  for (;;) {
+    record = &ring[pos & (LOG_RING_SIZE - 1)];
+    uint32_t seq = record->sequence.load(std::memory_order_acquire);
+    int32_t diff = (int32_t)(seq - pos);
+
+    if (diff == 0) {
+      if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  record->format = format;
+  record->timestamp = millis();
+  record->level = level;
+  record->argc = argc;
+  record->types = 0;
+  record->text[0] = '\0';
+
+  for (uint8_t i = 0; i < argc; i++) {
+    record->types |= (uint32_t)args[i].type << (i * 3);
+    record->args[i] = args[i].bits;
+    if (args[i].type == LOG_ARG_COPY) {
+      strlcpy(record->text, (const char*)args[i].bits, LOG_TEXT_SIZE);
+    }
+  }
+
+  written.fetch_add(1, std::memory_order_relaxed);
+  record->sequence.store(pos + 1, std::memory_order_release);
+}
+
+// ============================================
+// CONSUMER (output task only)
+// ============================================
+
+bool Logger::pop(LogRecord& out) {
+  LogRecord& record = ring[dequeuePos & (LOG_RING_SIZE - 1)];
+  uint32_t seq = record.sequence.load(std::memory_order_acquire);
+  if (seq != dequeuePos + 1) return false;
+
+  uint32_t waiting = enqueuePos.load(std::memory_order_relaxed) - dequeuePos;
+  if (waiting > highWater) highWater = waiting;
+
+  out.format = record.format;
+  out.timestamp = record.timestamp;
+  out.level = record.level;
+  out.argc = record.argc;
+  out.types = record.types;
+  memcpy(out.args, record.args, sizeof(out.args));
+  memcpy(out.text, record.text, sizeof(out.text));
+
+  record.sequence.store(dequeuePos + LOG_RING_SIZE, std::memory_order_release);
+  dequeuePos++;
+  return true;
+}
+
+// printf subset: flags/width/precision are kept, length modifiers are
+// dropped and the stored argument type decides the conversion.
+size_t Logger::format(const LogRecord& record, char* buf, size_t len) {
+  const char* p = record.format;
+  size_t n = 0;
+  uint8_t argIndex = 0;
+
+  while (*p && n + 1 < len) {
+    if (*p != '%') {
+      buf[n++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      buf[n++] = '%';
+      p += 2;
+      continue;
+    }
+
+    char spec[16];
+    size_t s = 0;
+    spec[s++] = *p++;
+    while (*p && strchr("-+ #0123456789.", *p) && s < sizeof(spec) - 3) spec[s++] = *p++;
+    while (*p && strchr("hlLzjt", *p)) p++;
+    char conv = *p ? *p++ : 's';
+
+    if (argIndex >= record.argc) break;
+    uintptr_t bits = record.args[argIndex];
+    uint8_t type = (record.types >> (argIndex * 3)) & 0x7;
+    argIndex++;
+
+    int written = 0;
+    switch (type) {
+      case LOG_ARG_FLOAT: {
+        float f;
+        uint32_t raw = bits;
+        memcpy(&f, &raw, sizeof(f));
+        spec[s++] = strchr("eEgG", conv) ? conv : 'f';
+        spec[s] = '\0';
+        written = snprintf(buf + n, len - n, spec, (double)f);
+        break;
+      }
+      case LOG_ARG_STR:
+      case LOG_ARG_COPY: {
+        const char* str = (type == LOG_ARG_COPY) ? record.text : (const char*)bits;
+        spec[s++] = 's';
+        spec[s] = '\0';
+        written = snprintf(buf + n, len - n, spec, str ? str : "(null)");
+        break;
+      }
+      default: {
+        if (conv == 'c' || conv == 'd' || conv == 'i' || conv == 'u' ||
+            conv == 'x' || conv == 'X' || conv == 'o') {
+          spec[s++] = conv;
+        } else {
+          spec[s++] = (type == LOG_ARG_INT) ? 'd' : 'u';
+        }
+        spec[s] = '\0';
+        if (type == LOG_ARG_INT) {
+          written = snprintf(buf + n, len - n, spec, (int)(intptr_t)bits);
+        } else {
+          written = snprintf(buf + n, len - n, spec, (unsigned)bits);
+        }
+        break;
+      }
+    }
+
+    if (written < 0) break;
+    n += min((size_t)written, len - n - 1);
+  }
+
+  buf[n] = '\0';
+  return n;
+}
+
+void Logger::printLine(uint8_t level, uint32_t timestamp, const char* line) {
+  char prefix[16];
+  snprintf(prefix, sizeof(prefix), "%7lu %c ", (unsigned long)timestamp,
+           LEVEL_CHARS[level < sizeof(LEVEL_CHARS) ? level : 0]);
+  Serial.print(prefix);
+  Serial.println(line);
+}
+
+int Logger::drain() {
+  LogRecord record;
+  char line[LOG_LINE_SIZE];
+  int count = 0;
+
+  while (pop(record)) {
+    format(record, line, sizeof(line));
+    printLine(record.level, record.timestamp, line);
+    printed++;
+    count++;
+  }
+
+  uint32_t drops = dropped.load(std::memory_order_relaxed);
+  if (drops != reportedDrops) {
+    snprintf(line, sizeof(line), "⚠️ log: %lu record(s) dropped (ring full)",
+             (unsigned long)(drops - reportedDrops));
+    printLine(LOG_LEVEL_WARN, millis(), line);
+    reportedDrops = drops;
+  }
+
+  return count;
+}
+
+// ============================================
+// UTILITIES
+// ============================================
+
+LogStats Logger::getStats() {
+  LogStats s;
+  s.written = written.load(std::memory_order_relaxed);
+  s.dropped = dropped.load(std::memory_order_relaxed);
+  s.printed = printed;
+  s.highWater = highWater;
+  return s;
+}
+
+void Logger::printStats() {
+  LogStats s = getStats();
+  LOG_INFO("[Log] written=%lu printed=%lu dropped=%lu highWater=%u/%d",
+           s.written, s.printed, s.dropped, s.highWater, LOG_RING_SIZE);
+}
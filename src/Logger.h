@@ -0,0 +1,167 @@
+// Logger.h
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+#include "config.h"
+
+// ============================================
+// LOG MACROS
+// ============================================
+// Levels above LOG_LEVEL compile to nothing - arguments are not even
+// evaluated. Formats are printf-style and must be string literals; %s
+// arguments must outlive the record (literals, static buffers). Wrap
+// anything short-lived in logCopy() - one per record, LOG_TEXT_SIZE max.
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(fmt, ...) logger.write(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(fmt, ...)  logger.write(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(fmt, ...)  do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(fmt, ...)  logger.write(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt, ...)  do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(fmt, ...) logger.write(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(fmt, ...) do {} while (0)
+#endif
+
+// ============================================
+// RECORD
+// ============================================
+enum LogArgType : uint8_t {
+  LOG_ARG_INT,
+  LOG_ARG_UINT,
+  LOG_ARG_FLOAT,
+  LOG_ARG_STR,      // pointer, printed later
+  LOG_ARG_COPY      // copied into LogRecord::text
+};
+
+struct LogArg {
+  uintptr_t bits;
+  uint8_t type;
+};
+
+struct LogCopy {
+  const char* text;
+};
+
+inline LogCopy logCopy(const char* text) { return LogCopy{ text }; }
+inline LogCopy logCopy(const String& text) { return LogCopy{ text.c_str() }; }
+
+// Format ID (the literal's address) + raw arguments; formatting
+// happens on the output task.
+struct LogRecord {
+  std::atomic<uint32_t> sequence;
+  const char* format;
+  uint32_t timestamp;
+  uint8_t level;
+  uint8_t argc;
+  uint32_t types;                 // 3 bits per argument
+  uintptr_t args[LOG_MAX_ARGS];
+  char text[LOG_TEXT_SIZE];
+};
+
+struct LogStats {
+  unsigned long written;
+  unsigned long dropped;          // ring full
+  unsigned long printed;
+  uint16_t highWater;             // most records waiting at once
+};
+
+// ============================================
+// ARGUMENT CAPTURE
+// ============================================
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, LogArg>::type
+toLogArg(T v) {
+  return LogArg{ (uintptr_t)(intptr_t)v, LOG_ARG_INT };
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, LogArg>::type
+toLogArg(T v) {
+  return LogArg{ (uintptr_t)v, LOG_ARG_UINT };
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, LogArg>::type
+toLogArg(T v) {
+  float f = v;
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  return LogArg{ bits, LOG_ARG_FLOAT };
+}
+
+inline LogArg toLogArg(const char* s) { return LogArg{ (uintptr_t)s, LOG_ARG_STR }; }
+inline LogArg toLogArg(LogCopy c)     { return LogArg{ (uintptr_t)c.text, LOG_ARG_COPY }; }
+
+template <typename... Args> struct LogCopyCount;
+template <> struct LogCopyCount<> { static const int value = 0; };
+template <typename T, typename... Rest> struct LogCopyCount<T, Rest...> {
+  static const int value = std::is_same<T, LogCopy>::value + LogCopyCount<Rest...>::value;
+};
+
+// ============================================
+// CLASS LOGGER
+// ============================================
+// Producers (loop(), AsyncTCP callbacks) reserve a slot in a bounded
+// lock-free ring (per-slot sequence numbers, one CAS per record); a
+// single output task below loop() priority formats and writes to
+// Serial. When the ring is full the record is dropped and counted, and
+// the output task reports the gap.
+class Logger {
+private:
+  LogRecord ring[LOG_RING_SIZE];
+  std::atomic<uint32_t> enqueuePos;
+  uint32_t dequeuePos;
+  std::atomic<uint32_t> dropped;
+  std::atomic<uint32_t> written;
+  uint32_t reportedDrops;
+  unsigned long printed;
+  uint16_t highWater;
+  bool started;
+
+  void push(uint8_t level, const char* format, const LogArg* args, uint8_t argc);
+  bool pop(LogRecord& out);
+  size_t format(const LogRecord& record, char* buf, size_t len);
+  void printLine(uint8_t level, uint32_t timestamp, const char* line);
+
+  static void taskEntry(void* param);
+
+public:
+  Logger();
+
+  // Start the output task
+  void begin();
+
+  template <typename... Args>
+  void write(uint8_t level, const char* format, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+    static_assert(LogCopyCount<Args...>::value <= 1, "one logCopy() per record");
+    const LogArg packed[sizeof...(Args) + 1] = { toLogArg(args)..., LogArg{ 0, 0 } };
+    push(level, format, packed, sizeof...(Args));
+  }
+
+  // Format and print everything queued. Returns records printed.
+  int drain();
+
+  LogStats getStats();
+  void printStats();
+};
+
+extern Logger logger;
+
+#endif
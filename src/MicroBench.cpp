@@ -0,0 +1,343 @@
+// MicroBench.cpp
+#include "MicroBench.h"
+#include <WiFiClient.h>
+#include "DeadbandPublisher.h"
+#include "PackedSample.h"
+#include "GasCalibration.h"
+#include "AlarmRules.h"
+#include "CommandParser.h"
+#include "HistoryStore.h"
+
+// ============================================
+// ALLOCATION COUNTER
+// ============================================
+#ifdef CONFIG_HEAP_USE_HOOKS
+static volatile uint32_t benchAllocs = 0;
+
+extern "C" void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+  benchAllocs++;
+}
+
+extern "C" void esp_heap_trace_free_hook(void* ptr) {
+}
+#endif
+
+// ============================================
+// FIXTURES
+// ============================================
+static volatile uint32_t benchSink = 0;
+
+static const SensorData BENCH_SAMPLE = { 23.45, 61.2, 187, 85.3, 400.0, false, 123456 };
+
+// Never connected: publishSensorData() would return before formatting,
+// so the case drives update() per channel. Each call formats with
+// dtostrf and publish() then returns at its connected() check.
+static WiFiClient offlineNet;
+static PubSubClient offlineMqtt(offlineNet);
+static DeadbandPublisher offlinePublisher(offlineMqtt);
+static AlarmRuleEngine benchRules;
+
+// Appends go to their own store so the query case always reads the same
+// hour of 5 s samples, ending when the cases were registered
+static HistoryStore benchHistoryWrite;
+static HistoryStore benchHistoryRead;
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+MicroBench::MicroBench(PubSubClient& mqtt) : client(mqtt) {
+  caseCount = 0;
+}
+
+bool MicroBench::add(const char* name, BenchFunction fn, void* context) {
+  if (caseCount >= BENCH_MAX_CASES || fn == nullptr) return false;
+
+  BenchCase& bench = cases[caseCount++];
+  bench.name = name;
+  bench.fn = fn;
+  bench.context = context;
+  return true;
+}
+
+uint8_t MicroBench::count() {
+  return caseCount;
+}
+
+const BenchCase& MicroBench::at(uint8_t index) {
+  return cases[index < caseCount ? index : 0];
+}
+
+void MicroBench::addFirmwareCases(PushsaferNotifier& push, ThingSpeakLogger& cloud) {
+  offlinePublisher.begin(false, 0, false);
+  offlinePublisher.addSensorChannels(TOPIC_TEMPERATURE, TOPIC_HUMIDITY, TOPIC_SMOKE,
+                                     TOPIC_DISTANCE_OUT, TOPIC_DISTANCE_IN, TOPIC_PIR);
+  benchRules.begin(ALARM_RULES, ALARM_RULE_COUNT, nullptr);
+  cloud.updateSensorData(BENCH_SAMPLE);   // refreshed again on the next upload tick
+
+  SensorData sample = BENCH_SAMPLE;
+  unsigned long now = millis();
+  for (int i = 3600 / 5 - 1; i >= 0; i--) {
+    sample.timestamp = now - i * 5000UL;
+    sample.temperatureDHT = BENCH_SAMPLE.temperatureDHT + (i % 7) * 0.1;
+    benchHistoryRead.append(sample);
+  }
+
+  add("pushsafer.renderTemplate", benchRenderTemplate, &push);
+  add("pushsafer.renderNotification", benchRenderNotification, &push);
+  add("thingspeak.buildUrl", benchThingSpeakUrl, &cloud);
+  add("mqtt.formatSensorData", benchFormatSensorData, &offlinePublisher);
+  add("sample.pack", benchSamplePack);
+  add("sample.unpack", benchSampleUnpack);
+  add("gas.ppm", benchGasPpm);
+  add("rules.evaluate", benchRuleEvaluate, &benchRules);
+  add("mqtt.doorCommand", benchDoorCommand);
+  add("history.append", benchHistoryAppend, &benchHistoryWrite);
+  add("history.rollup", benchHistoryRollup, &benchHistoryWrite);
+  add("history.query", benchHistoryQuery, &benchHistoryRead);
+}
+
+// ============================================
+// MEASUREMENT
+// ============================================
+
+// Doubles the batch until it runs BENCH_MIN_TIME, then times that batch
+// BENCH_REPETITIONS times and keeps the fastest.
+BenchResult MicroBench::measure(const BenchCase& bench) {
+  BenchResult result;
+  memset(&result, 0, sizeof(result));
+
+  uint32_t heapBefore = ESP.getFreeHeap();
+  bench.fn(bench.context);   // warm-up: lazy statics, caches
+
+  uint32_t batch = 1;
+  for (;;) {
+    unsigned long start = micros();
+    for (uint32_t i = 0; i < batch; i++) bench.fn(bench.context);
+    if (micros() - start >= BENCH_MIN_TIME * 1000UL || batch >= (1UL << 24)) break;
+    batch *= 2;
+  }
+
+  float best = -1;
+  result.allocsPerOp = -1;
+
+  for (uint8_t rep = 0; rep < BENCH_REPETITIONS; rep++) {
+#ifdef CONFIG_HEAP_USE_HOOKS
+    uint32_t allocsBefore = benchAllocs;
+#endif
+    unsigned long start = micros();
+    for (uint32_t i = 0; i < batch; i++) bench.fn(bench.context);
+    unsigned long elapsed = micros() - start;
+
+    float ns = elapsed * 1000.0 / batch;
+    if (best < 0 || ns < best) best = ns;
+#ifdef CONFIG_HEAP_USE_HOOKS
+    float allocs = (float)(benchAllocs - allocsBefore) / batch;
+    if (result.allocsPerOp < 0 || allocs < result.allocsPerOp) result.allocsPerOp = allocs;
+#endif
+  }
+
+  result.nsPerOp = best;
+  result.iterations = batch;
+  result.heapDelta = (long)heapBefore - (long)ESP.getFreeHeap();
+  return result;
+}
+
+// NVS keys are limited to 15 characters: "b" + FNV-1a of the name
+void MicroBench::baselineKey(const char* name, char* key) {
+  uint32_t hash = 2166136261UL;
+  for (const char* p = name; *p; p++) {
+    hash = (hash ^ (uint8_t)*p) * 16777619UL;
+  }
+  snprintf(key, 10, "b%08lx", (unsigned long)hash);
+}
+
+int MicroBench::run(uint8_t mode) {
+  if (mode == BENCH_MODE_OFF || caseCount == 0) return 0;
+
+  bool save = (mode == BENCH_MODE_SAVE);
+  bool compare = (mode == BENCH_MODE_COMPARE);
+  int regressions = 0;
+
+  LOG_INFO("[Bench] %u cases, %s", caseCount,
+           save ? "saving baseline" : compare ? "comparing to baseline" : "report only");
+
+  prefs.begin("bench", !save);
+
+  for (uint8_t c = 0; c < caseCount; c++) {
+    const BenchCase& bench = cases[c];
+    BenchResult& result = results[c];
+    result = measure(bench);
+
+    char key[10];
+    baselineKey(bench.name, key);
+    result.baselineNs = prefs.getFloat(key, 0);
+    result.regressed = compare && result.baselineNs > 0 &&
+                       result.nsPerOp > result.baselineNs * (100 + BENCH_REGRESSION_PCT) / 100;
+    if (save) prefs.putFloat(key, result.nsPerOp);
+
+    LOG_INFO("[Bench] %-24s %10.1f ns/op %6.2f allocs/op heap %ld",
+             bench.name, result.nsPerOp, result.allocsPerOp, result.heapDelta);
+    if (result.regressed) {
+      regressions++;
+      LOG_ERROR("❌ [Bench] %s regressed: %.1f -> %.1f ns/op", bench.name,
+                result.baselineNs, result.nsPerOp);
+    }
+
+    publishResult(bench, result, mode);
+  }
+
+  prefs.end();
+
+  if (compare) {
+    if (regressions > 0) {
+      LOG_ERROR("❌ [Bench] %d case(s) slower than baseline + %d%%", regressions, BENCH_REGRESSION_PCT);
+    } else {
+      LOG_INFO("✓ [Bench] no regressions (threshold %d%%)", BENCH_REGRESSION_PCT);
+    }
+  }
+
+  if (client.connected()) {
+    char json[128];
+    snprintf(json, sizeof(json),
+             "{\"summary\":true,\"mode\":%u,\"cases\":%u,\"regressions\":%d,\"threshold_pct\":%d}",
+             mode, caseCount, regressions, BENCH_REGRESSION_PCT);
+    client.publish(TOPIC_DIAG_BENCH, json);
+  }
+
+  return regressions;
+}
+
+// {"name":"gas.ppm","ns":812.4,"allocs":0.00,"heap":0,"iters":32768,
+//  "baseline_ns":805.1,"regressed":false}     allocs is null when unmeasured
+void MicroBench::publishResult(const BenchCase& bench, const BenchResult& result, uint8_t mode) {
+  if (!client.connected()) return;
+
+  char allocs[16];
+  if (result.allocsPerOp < 0) {
+    strlcpy(allocs, "null", sizeof(allocs));
+  } else {
+    snprintf(allocs, sizeof(allocs), "%.2f", result.allocsPerOp);
+  }
+
+  char json[256];
+  snprintf(json, sizeof(json),
+           "{\"name\":\"%s\",\"mode\":%u,\"ns\":%.1f,\"allocs\":%s,\"heap\":%ld,\"iters\":%lu,"
+           "\"baseline_ns\":%.1f,\"regressed\":%s}",
+           bench.name, mode, result.nsPerOp, allocs, result.heapDelta,
+           (unsigned long)result.iterations, result.baselineNs,
+           result.regressed ? "true" : "false");
+  client.publish(TOPIC_DIAG_BENCH, json);
+}
+
+int MicroBench::parseMode(const String& command) {
+  if (command == "RUN") return BENCH_MODE_RUN;
+  if (command == "SAVE") return BENCH_MODE_SAVE;
+  if (command == "COMPARE") return BENCH_MODE_COMPARE;
+  return BENCH_MODE_OFF;
+}
+
+// ============================================
+// BUILT-IN CASES
+// ============================================
+
+void MicroBench::benchRenderTemplate(void* context) {
+  const NotifyArg args[] = { 65.2f, 850, 40.1f };
+  benchSink += ((PushsaferNotifier*)context)->renderTemplate(NOTIFY_FIRE_ALERT, args, 3);
+}
+
+void MicroBench::benchRenderNotification(void* context) {
+  static PushNotification notif;
+  if (notif.title.length() == 0) {
+    notif.title = "🔥 HỎA HOẠN!";
+    notif.message = "Phát hiện cháy trong garage! Nhiệt độ: 65.2°C, Khói: 850, Độ ẩm: 40.1%";
+    notif.priority = PRIORITY_EMERGENCY;
+    notif.sound = SOUND_ALARM;
+    notif.icon = ICON_FIRE;
+    notif.iconColor = "#FF6600";
+    notif.vibration = VIBRATION_HIGH;
+    notif.timeToLive = 0;
+    notif.retry = 60;
+    notif.expire = 3600;
+    notif.device = "a";
+  }
+  benchSink += ((PushsaferNotifier*)context)->renderNotification(notif);
+}
+
+void MicroBench::benchThingSpeakUrl(void* context) {
+  String url = ((ThingSpeakLogger*)context)->buildUpdateUrl(0);
+  benchSink += url.length();
+}
+
+// Channels 0-5 are the addSensorChannels() set; begin(false, ...) so
+// no deadband check short-circuits the formatting
+void MicroBench::benchFormatSensorData(void* context) {
+  DeadbandPublisher* publisher = (DeadbandPublisher*)context;
+  publisher->update(0, BENCH_SAMPLE.temperatureDHT);
+  publisher->update(1, BENCH_SAMPLE.humidity);
+  publisher->update(2, BENCH_SAMPLE.smokeLevel);
+  publisher->update(3, BENCH_SAMPLE.distanceOutside);
+  publisher->update(4, BENCH_SAMPLE.distanceInside);
+  publisher->update(5, BENCH_SAMPLE.pirMotion ? 1 : 0, BENCH_SAMPLE.pirMotion ? "DETECTED" : "CLEAR");
+}
+
+void MicroBench::benchSamplePack(void* context) {
+  PackedSample packed = packSensorData(BENCH_SAMPLE);
+  benchSink += packed.lo;
+}
+
+void MicroBench::benchSampleUnpack(void* context) {
+  static const PackedSample packed = packSensorData(BENCH_SAMPLE);
+  SensorData data = unpackSensorData(packed);
+  benchSink += data.smokeLevel;
+}
+
+void MicroBench::benchGasPpm(void* context) {
+  static int raw = 0;
+  raw = (raw + 37) & GAS_ADC_MAX;
+  benchSink += gasCalibration.ppm(raw);
+}
+
+void MicroBench::benchRuleEvaluate(void* context) {
+  static uint32_t step = 0;
+  float inputs[RULE_IN_COUNT];
+  inputs[RULE_IN_TEMPERATURE] = 20 + (step % 100) * 0.5;
+  inputs[RULE_IN_HUMIDITY] = 60;
+  inputs[RULE_IN_SMOKE] = (step * 7) % 1000;
+  inputs[RULE_IN_PIR] = (step & 16) ? 1 : 0;
+  inputs[RULE_IN_DOORS_CLOSED] = 1;
+  ((AlarmRuleEngine*)context)->evaluate(inputs, step * SENSOR_READ_INTERVAL);
+  step++;
+}
+
+// mqttCallback() payload copy + door command parsing, without actuation
+void MicroBench::benchDoorCommand(void* context) {
+  static const char payload[] = "OPEN:0#a1b2c3";
+  DoorCommand cmd;
+  String message = CommandParser::payloadToString((const byte*)payload, sizeof(payload) - 1);
+  benchSink += CommandParser::parseDoor(message, BAY_COUNT, cmd);
+}
+
+// One sensorJob() append: 5 s steps, so a minute closes every 12th call
+void MicroBench::benchHistoryAppend(void* context) {
+  static SensorData sample = BENCH_SAMPLE;
+  sample.timestamp += 5000;
+  ((HistoryStore*)context)->append(sample);
+}
+
+// Every append closes the open minute (and every 60th the hour)
+void MicroBench::benchHistoryRollup(void* context) {
+  static SensorData sample = BENCH_SAMPLE;
+  sample.timestamp += 60000;
+  ((HistoryStore*)context)->append(sample);
+}
+
+// handleHistoryQuery() without the publish: parse, then the first part
+// of the last hour of minute rollups
+void MicroBench::benchHistoryQuery(void* context) {
+  static const String payload = "m,temp,3600";
+  char reply[MQTT_BUFFER_SIZE - 64];
+  HistoryQuery query;
+  if (!HistoryStore::parseQuery(payload, query)) return;
+  benchSink += ((HistoryStore*)context)->encodeReply(query, 0, reply, sizeof(reply));
+}
@@ -0,0 +1,82 @@
+// MicroBench.h
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <PubSubClient.h>
+#include "config.h"
+#include "Logger.h"
+#include "PushsaferNotifier.h"
+#include "ThingSpeakLogger.h"
+
+typedef void (*BenchFunction)(void* context);
+
+struct BenchCase {
+  const char* name;
+  BenchFunction fn;
+  void* context;
+};
+
+struct BenchResult {
+  float nsPerOp;          // best of BENCH_REPETITIONS
+  float allocsPerOp;      // -1 = not measurable in this build
+  long heapDelta;         // bytes still held after the run (leak check)
+  uint32_t iterations;
+  float baselineNs;       // 0 = no baseline stored
+  bool regressed;
+};
+
+// ============================================
+// CLASS MICRO BENCH
+// ============================================
+// Allocations are counted through the ESP-IDF heap hooks, which only
+// exist when the core is built with CONFIG_HEAP_USE_HOOKS (not the stock
+// arduino-esp32 build - allocs/op is then null); other tasks (WiFi,
+// logger) allocating during a run are counted too. host/garage_bench
+// registers the same cases with Google Benchmark and always counts them.
+class MicroBench {
+private:
+  PubSubClient& client;
+  Preferences prefs;
+  BenchCase cases[BENCH_MAX_CASES];
+  BenchResult results[BENCH_MAX_CASES];
+  uint8_t caseCount;
+
+  BenchResult measure(const BenchCase& bench);
+  void publishResult(const BenchCase& bench, const BenchResult& result, uint8_t mode);
+  static void baselineKey(const char* name, char* key);
+
+  // Built-in cases
+  static void benchRenderTemplate(void* context);
+  static void benchRenderNotification(void* context);
+  static void benchThingSpeakUrl(void* context);
+  static void benchFormatSensorData(void* context);
+  static void benchSamplePack(void* context);
+  static void benchSampleUnpack(void* context);
+  static void benchGasPpm(void* context);
+  static void benchRuleEvaluate(void* context);
+  static void benchDoorCommand(void* context);
+  static void benchHistoryAppend(void* context);
+  static void benchHistoryRollup(void* context);
+  static void benchHistoryQuery(void* context);
+
+public:
+  MicroBench(PubSubClient& mqtt);
+
+  bool add(const char* name, BenchFunction fn, void* context = nullptr);
+  uint8_t count();
+  const BenchCase& at(uint8_t index);
+
+  // Pushsafer / ThingSpeak formatting, MQTT sensor payloads, sample
+  // codec, gas lookup, alarm rule evaluation, command parsing and the
+  // history store
+  void addFirmwareCases(PushsaferNotifier& push, ThingSpeakLogger& cloud);
+
+  // BENCH_MODE_RUN / SAVE / COMPARE; returns the number of regressions
+  int run(uint8_t mode);
+
+  static int parseMode(const String& command);
+};
+
+#endif
@@ -0,0 +1,67 @@
+// PackedSample.cpp
+#include "PackedSample.h"
+
+// ============================================
+// ROUND-TRIP CHECKS (compile time)
+// ============================================
+static_assert(sizeof(PackedSample) == 12, "PackedSample must stay 12 bytes");
+
+constexpr SensorFixed SAMPLE_MIN     = { -SAMPLE_TEMP_OFFSET, 0, 0, 0, 0, 0, 0 };
+constexpr SensorFixed SAMPLE_MAX     = { SAMPLE_TEMP_MAX, SAMPLE_HUMIDITY_MAX, SAMPLE_SMOKE_MAX,
+                                         SAMPLE_DISTANCE_MAX, SAMPLE_DISTANCE_MAX,
+                                         SAMPLE_FLAG_PIR | SAMPLE_FLAG_DHT_VALID, 0xFFFFFFFF };
+constexpr SensorFixed SAMPLE_TYPICAL = { 2345, 612, 187, 853, 4000, SAMPLE_FLAG_DHT_VALID, 123456 };
+constexpr SensorFixed SAMPLE_NO_DHT  = { 0, 0, 950, 120, 35, SAMPLE_FLAG_PIR, 42 };
+constexpr SensorFixed SAMPLE_FROST   = { -1275, 1000, 1, 1, 4095, SAMPLE_FLAG_DHT_VALID, 1 };
+
+static_assert(sameSample(unpackSample(packSample(SAMPLE_MIN)), SAMPLE_MIN), "round trip: min");
+static_assert(sameSample(unpackSample(packSample(SAMPLE_MAX)), SAMPLE_MAX), "round trip: max");
+static_assert(sameSample(unpackSample(packSample(SAMPLE_TYPICAL)), SAMPLE_TYPICAL), "round trip: typical");
+static_assert(sameSample(unpackSample(packSample(SAMPLE_NO_DHT)), SAMPLE_NO_DHT), "round trip: DHT failure");
+static_assert(sameSample(unpackSample(packSample(SAMPLE_FROST)), SAMPLE_FROST), "round trip: below zero");
+static_assert((int)(MAX_DISTANCE * 10) <= SAMPLE_DISTANCE_MAX, "MAX_DISTANCE does not fit the distance field");
+
+// ============================================
+// FLOAT <-> FIXED
+// ============================================
+
+static long clampLong(long v, long lo, long hi) {
+  return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+SensorFixed toFixed(const SensorData& data) {
+  SensorFixed f;
+  bool dhtValid = !isnan(data.temperatureDHT) && !isnan(data.humidity);
+
+  f.temperatureCenti = dhtValid ? clampLong(lroundf(data.temperatureDHT * 100),
+                                            -SAMPLE_TEMP_OFFSET, SAMPLE_TEMP_MAX) : 0;
+  f.humidityDeci = dhtValid ? clampLong(lroundf(data.humidity * 10), 0, SAMPLE_HUMIDITY_MAX) : 0;
+  f.smokePpm = clampLong(data.smokeLevel, 0, SAMPLE_SMOKE_MAX);
+  f.distanceOutsideMm = clampLong(lroundf(data.distanceOutside * 10), 0, SAMPLE_DISTANCE_MAX);
+  f.distanceInsideMm = clampLong(lroundf(data.distanceInside * 10), 0, SAMPLE_DISTANCE_MAX);
+  f.flags = (data.pirMotion ? SAMPLE_FLAG_PIR : 0) | (dhtValid ? SAMPLE_FLAG_DHT_VALID : 0);
+  f.timestamp = data.timestamp;
+  return f;
+}
+
+SensorData fromFixed(const SensorFixed& f) {
+  SensorData data;
+  bool dhtValid = f.flags & SAMPLE_FLAG_DHT_VALID;
+
+  data.temperatureDHT = dhtValid ? f.temperatureCenti / 100.0f : NAN;
+  data.humidity = dhtValid ? f.humidityDeci / 10.0f : NAN;
+  data.smokeLevel = f.smokePpm;
+  data.distanceOutside = f.distanceOutsideMm / 10.0f;
+  data.distanceInside = f.distanceInsideMm / 10.0f;
+  data.pirMotion = f.flags & SAMPLE_FLAG_PIR;
+  data.timestamp = f.timestamp;
+  return data;
+}
+
+PackedSample packSensorData(const SensorData& data) {
+  return packSample(toFixed(data));
+}
+
+SensorData unpackSensorData(const PackedSample& sample) {
+  return fromFixed(unpackSample(sample));
+}
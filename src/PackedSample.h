@@ -0,0 +1,103 @@
+// PackedSample.h
+#ifndef PACKED_SAMPLE_H
+#define PACKED_SAMPLE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "SensorModule.h"
+
+// ============================================
+// FIXED-POINT SAMPLE
+// ============================================
+// Integer view of SensorData at sensor resolution:
+//   temperature  centi-°C     (DHT22: 0.1 °C)
+//   humidity     deci-%       (DHT22: 0.1 %)
+//   smoke        ppm
+//   distances    mm           (HC-SR04: ~3 mm)
+#define SAMPLE_FLAG_PIR        0x01
+#define SAMPLE_FLAG_DHT_VALID  0x02   // cleared when the DHT read returned NaN
+
+struct SensorFixed {
+  int16_t temperatureCenti;
+  uint16_t humidityDeci;
+  uint16_t smokePpm;
+  uint16_t distanceOutsideMm;
+  uint16_t distanceInsideMm;
+  uint8_t flags;
+  uint32_t timestamp;           // millis()
+};
+
+// ============================================
+// PACKED RECORD (12 bytes)
+// ============================================
+// timestamp is kept whole; the remaining 64 bits are
+//   [ 0..13] temperature + SAMPLE_TEMP_OFFSET  (-40.00 .. +123.83 °C)
+//   [14..23] humidity                          (0 .. 102.3 %)
+//   [24..37] smoke                             (0 .. 16383 ppm)
+//   [38..49] outside distance                  (0 .. 4095 mm)
+//   [50..61] inside distance                   (0 .. 4095 mm)
+//   [62..63] flags
+// Packing a SensorFixed and unpacking it again is exact.
+struct PackedSample {
+  uint32_t timestamp;
+  uint32_t lo;
+  uint32_t hi;
+};
+
+#define SAMPLE_TEMP_OFFSET     4000
+#define SAMPLE_TEMP_MAX        (0x3FFF - SAMPLE_TEMP_OFFSET)
+#define SAMPLE_HUMIDITY_MAX    0x3FF
+#define SAMPLE_SMOKE_MAX       0x3FFF
+#define SAMPLE_DISTANCE_MAX    0xFFF
+
+constexpr uint64_t sampleBits(const SensorFixed& f) {
+  return ((uint64_t)((f.temperatureCenti + SAMPLE_TEMP_OFFSET) & 0x3FFF))
+       | ((uint64_t)(f.humidityDeci & 0x3FF) << 14)
+       | ((uint64_t)(f.smokePpm & 0x3FFF) << 24)
+       | ((uint64_t)(f.distanceOutsideMm & 0xFFF) << 38)
+       | ((uint64_t)(f.distanceInsideMm & 0xFFF) << 50)
+       | ((uint64_t)(f.flags & 0x3) << 62);
+}
+
+constexpr PackedSample packSample(const SensorFixed& f) {
+  return PackedSample{ f.timestamp, (uint32_t)sampleBits(f), (uint32_t)(sampleBits(f) >> 32) };
+}
+
+constexpr SensorFixed unpackBits(uint32_t timestamp, uint64_t b) {
+  return SensorFixed{
+    (int16_t)((int)(b & 0x3FFF) - SAMPLE_TEMP_OFFSET),
+    (uint16_t)((b >> 14) & 0x3FF),
+    (uint16_t)((b >> 24) & 0x3FFF),
+    (uint16_t)((b >> 38) & 0xFFF),
+    (uint16_t)((b >> 50) & 0xFFF),
+    (uint8_t)((b >> 62) & 0x3),
+    timestamp
+  };
+}
+
+constexpr SensorFixed unpackSample(const PackedSample& p) {
+  return unpackBits(p.timestamp, ((uint64_t)p.hi << 32) | p.lo);
+}
+
+constexpr bool sameSample(const SensorFixed& a, const SensorFixed& b) {
+  return a.temperatureCenti == b.temperatureCenti &&
+         a.humidityDeci == b.humidityDeci &&
+         a.smokePpm == b.smokePpm &&
+         a.distanceOutsideMm == b.distanceOutsideMm &&
+         a.distanceInsideMm == b.distanceInsideMm &&
+         a.flags == b.flags &&
+         a.timestamp == b.timestamp;
+}
+
+// ============================================
+// CONVERSIONS
+// ============================================
+
+// Rounds to the fixed-point resolution and clamps to the packed ranges
+SensorFixed toFixed(const SensorData& data);
+SensorData fromFixed(const SensorFixed& fixed);
+
+PackedSample packSensorData(const SensorData& data);
+SensorData unpackSensorData(const PackedSample& sample);
+
+#endif
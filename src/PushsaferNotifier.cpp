@@ -16,6 +16,11 @@ PushsaferNotifier::PushsaferNotifier() {
     initialized = false;
     lastSendTime = 0;
     sendCount = 0;
+    memset(&tlsStats, 0, sizeof(tlsStats));
+    requestQueue = nullptr;
+    resultQueue = nullptr;
+    queueDropped = 0;
+    parseApiUrl();
 }
 
 PushsaferNotifier::PushsaferNotifier(String key) {
@@ -24,6 +29,11 @@ PushsaferNotifier::PushsaferNotifier(String key) {
     initialized = false;
     lastSendTime = 0;
     sendCount = 0;
+    memset(&tlsStats, 0, sizeof(tlsStats));
+    requestQueue = nullptr;
+    resultQueue = nullptr;
+    queueDropped = 0;
+    parseApiUrl();
 }
 
 // ============================================
@@ -31,23 +41,36 @@ PushsaferNotifier::PushsaferNotifier(String key) {
 // ============================================
 
 void PushsaferNotifier::begin() {
-    Serial.println("[Pushsafer] Initializing...");
+    LOG_INFO("[Pushsafer] Initializing...");
     
     if (apiKey == "YOUR_PUSHSAFER_KEY" || apiKey.length() == 0) {
-        Serial.println("[Pushsafer] ⚠️ Warning: API Key not set!");
-        Serial.println("[Pushsafer] Get your key from: https://www.pushsafer.com/");
+        LOG_WARN("[Pushsafer] ⚠️ Warning: API Key not set!");
+        LOG_INFO("[Pushsafer] Get your key from: https://www.pushsafer.com/");
         initialized = false;
         return;
     }
     
     if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("[Pushsafer] ⚠️ Warning: WiFi not connected!");
+        LOG_WARN("[Pushsafer] ⚠️ Warning: WiFi not connected!");
         initialized = false;
         return;
     }
     
+#ifdef PUSHSAFER_ROOT_CA
+    tlsClient.setCACert(PUSHSAFER_ROOT_CA);
+#else
+    if (!PUSHSAFER_ALLOW_INSECURE) {
+        LOG_ERROR("[Pushsafer] ✗ PUSHSAFER_ROOT_CA not set, refusing unverified TLS");
+        initialized = false;
+        return;
+    }
+    LOG_WARN("[Pushsafer] ⚠️ Server certificate NOT verified (define PUSHSAFER_ROOT_CA)");
+    tlsClient.setInsecure();
+#endif
+    tlsClient.setHandshakeTimeout(PUSHSAFER_HANDSHAKE_TIMEOUT);
+    
     initialized = true;
-    Serial.println("[Pushsafer] Ready!");
+    LOG_INFO("[Pushsafer] Ready!");
 }
 
 void PushsaferNotifier::begin(String key) {
@@ -60,140 +83,276 @@ bool PushsaferNotifier::isReady() {
 }
 
 // ============================================
-// HELPERS
+// TLS CONNECTION
 // ============================================
 
-String PushsaferNotifier::urlEncode(String str) {
-    String encoded = "";
-    char c;
-    char code0;
-    char code1;
+void PushsaferNotifier::parseApiUrl() {
+    // https://host[:port]/path
+    int hostStart = apiUrl.indexOf("://");
+    hostStart = (hostStart < 0) ? 0 : hostStart + 3;
     
-    for (unsigned int i = 0; i < str.length(); i++) {
-        c = str.charAt(i);
-        if (c == ' ') {
-            encoded += '+';
-        } else if (isalnum(c)) {
-            encoded += c;
-        } else {
-            code1 = (c & 0xf) + '0';
-            if ((c & 0xf) > 9) {
-                code1 = (c & 0xf) - 10 + 'A';
-            }
-            c = (c >> 4) & 0xf;
-            code0 = c + '0';
-            if (c > 9) {
-                code0 = c - 10 + 'A';
-            }
-            encoded += '%';
-            encoded += code0;
-            encoded += code1;
-        }
+    int pathStart = apiUrl.indexOf('/', hostStart);
+    String hostPort = (pathStart < 0) ? apiUrl.substring(hostStart)
+                                      : apiUrl.substring(hostStart, pathStart);
+    
+    int colon = hostPort.indexOf(':');
+    if (colon < 0) {
+        apiHost = hostPort;
+        apiPort = 443;
+    } else {
+        apiHost = hostPort.substring(0, colon);
+        apiPort = hostPort.substring(colon + 1).toInt();
     }
-    return encoded;
 }
 
-String PushsaferNotifier::buildPostData(PushNotification notification) {
-    String postData = "";
+bool PushsaferNotifier::connectTls() {
+    unsigned long start = millis();
+    bool ok = tlsClient.connect(apiHost.c_str(), apiPort);
+    unsigned long elapsed = millis() - start;
     
-    // API Key (required)
-    postData += "k=" + apiKey;
+    if (!ok) {
+        tlsStats.failures++;
+        LOG_WARN("[Pushsafer] ✗ TLS connect failed after %lu ms", elapsed);
+        return false;
+    }
     
-    // Title (required)
-    if (notification.title.length() > 0) {
-        postData += "&t=" + urlEncode(notification.title);
+    tlsStats.lastHandshakeMs = elapsed;
+    if (tlsClient.resumed()) {
+        tlsStats.resumed++;
+        tlsStats.totalResumedMs += elapsed;
+        LOG_INFO("[Pushsafer] TLS session resumed: %lu ms", elapsed);
+        return true;
     }
     
-    // Message (required)
-    if (notification.message.length() > 0) {
-        postData += "&m=" + urlEncode(notification.message);
+    tlsStats.handshakes++;
+    tlsStats.totalHandshakeMs += elapsed;
+    if (elapsed > tlsStats.maxHandshakeMs) {
+        tlsStats.maxHandshakeMs = elapsed;
     }
     
-    // Priority
-    postData += "&pr=" + String(notification.priority);
+    LOG_INFO("[Pushsafer] TLS full handshake: %lu ms", elapsed);
+    return true;
+}
+
+bool PushsaferNotifier::warmUpTls() {
+    if (!isReady()) return false;
     
-    // Sound
-    if (notification.sound >= 0) {
-        postData += "&s=" + String(notification.sound);
+    bool ok = connectTls();
+    tlsClient.stop();
+    return ok;
+}
+
+const TlsStats& PushsaferNotifier::getTlsStats() {
+    return tlsStats;
+}
+
+void PushsaferNotifier::printTlsStats() {
+    unsigned long connects = tlsStats.handshakes + tlsStats.resumed;
+    LOG_INFO("[Pushsafer] TLS full handshakes=%lu avg=%lums max=%lums failed=%lu last=%lums",
+             tlsStats.handshakes,
+             tlsStats.handshakes ? tlsStats.totalHandshakeMs / tlsStats.handshakes : 0,
+             tlsStats.maxHandshakeMs, tlsStats.failures, tlsStats.lastHandshakeMs);
+    LOG_INFO("[Pushsafer] TLS resumed=%lu avg=%lums (hit %lu%%)",
+             tlsStats.resumed,
+             tlsStats.resumed ? tlsStats.totalResumedMs / tlsStats.resumed : 0,
+             connects ? tlsStats.resumed * 100 / connects : 0);
+    if (queueDropped > 0) {
+        LOG_WARN("[Pushsafer] %lu notification(s) dropped, send queue full", queueDropped);
     }
+}
+
+// ============================================
+// RENDER POST DATA
+// ============================================
+
+// Ghi thẳng vào postBuffer; khi tràn thì dừng ghi và đánh dấu overflow
+struct PostWriter {
+    char* buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
     
-    // Icon
-    if (notification.icon > 0) {
-        postData += "&i=" + String(notification.icon);
+    PostWriter(char* buffer, size_t capacity) : buf(buffer), cap(capacity), len(0), overflow(false) {
+        buf[0] = '\0';
     }
     
-    // Icon Color
-    if (notification.iconColor.length() > 0) {
-        postData += "&c=" + urlEncode(notification.iconColor);
+    void put(char c) {
+        if (len + 1 >= cap) {
+            overflow = true;
+            return;
+        }
+        buf[len++] = c;
+        buf[len] = '\0';
     }
     
-    // Vibration
-    if (notification.vibration > 0) {
-        postData += "&v=" + String(notification.vibration);
+    void raw(const char* str) {
+        while (*str) put(*str++);
     }
     
-    // Device
-    if (notification.device.length() > 0) {
-        postData += "&d=" + notification.device;
-    } else {
-        postData += "&d=a";  // Default: all devices
+    // URL encode (form): ' ' -> '+', chữ/số giữ nguyên, còn lại %XX
+    void encodedChar(char c) {
+        static const char HEX_DIGITS[] = "0123456789ABCDEF";
+        if (c == ' ') {
+            put('+');
+        } else if (isalnum(c)) {
+            put(c);
+        } else {
+            put('%');
+            put(HEX_DIGITS[(c >> 4) & 0xF]);
+            put(HEX_DIGITS[c & 0xF]);
+        }
     }
     
-    // Time to Live
-    if (notification.timeToLive > 0) {
-        postData += "&l=" + String(notification.timeToLive);
+    void encoded(const char* str) {
+        while (*str) encodedChar(*str++);
     }
     
-    // Retry (for priority 2)
-    if (notification.retry > 0) {
-        postData += "&re=" + String(notification.retry);
+    void number(const char* key, long value) {
+        char digits[16];
+        snprintf(digits, sizeof(digits), "%ld", value);
+        raw(key);
+        raw(digits);
+    }
+    
+    void arg(const NotifyArg& a) {
+        char text[16];
+        switch (a.type) {
+            case NotifyArg::ARG_INT:
+                snprintf(text, sizeof(text), "%ld", a.i);
+                encoded(text);
+                break;
+            case NotifyArg::ARG_FLOAT:
+                snprintf(text, sizeof(text), "%.1f", a.f);
+                encoded(text);
+                break;
+            case NotifyArg::ARG_TEXT:
+                encoded(a.s);
+                break;
+            case NotifyArg::ARG_FLAG:
+                raw(a.b ? "YES" : "NO");
+                break;
+        }
+    }
+    
+    // Thay "{}" bằng tham số tiếp theo
+    void pattern(const char* str, const NotifyArg* args, size_t argCount, size_t& next) {
+        while (*str) {
+            if (str[0] == '{' && str[1] == '}') {
+                if (next < argCount) arg(args[next++]);
+                str += 2;
+            } else {
+                encodedChar(*str++);
+            }
+        }
+    }
+    
+    // Các tham số chung sau title/message
+    void options(int priority, int sound, int icon, const char* iconColor, const char* device,
+                 int vibration, int timeToLive, int retry, int expire) {
+        number("&pr=", priority);
+        if (sound >= 0) number("&s=", sound);
+        if (icon > 0) number("&i=", icon);
+        if (iconColor[0]) {
+            raw("&c=");
+            encoded(iconColor);
+        }
+        if (vibration > 0) number("&v=", vibration);
+        raw("&d=");
+        raw(device[0] ? device : "a");   // Default: all devices
+        if (timeToLive > 0) number("&l=", timeToLive);
+        if (retry > 0) number("&re=", retry);       // for priority 2
+        if (expire > 0) number("&ex=", expire);     // for priority 2
     }
+};
+
+size_t PushsaferNotifier::renderTemplate(NotifyId id, const NotifyArg* args, size_t argCount) {
+    if (id >= NOTIFY_COUNT) return 0;
+    const NotifyTemplate& tpl = NOTIFY_CATALOG[id];
+    
+    PostWriter out(postBuffer, sizeof(postBuffer));
+    size_t next = 0;
+    
+    out.raw("k=");
+    out.raw(apiKey.c_str());
+    out.raw("&t=");
+    out.pattern(tpl.title, args, argCount, next);
+    out.raw("&m=");
+    out.pattern(tpl.message, args, argCount, next);
+    out.options(tpl.priority, tpl.sound, tpl.icon, tpl.iconColor, "a",
+                tpl.vibration, tpl.timeToLive, tpl.retry, tpl.expire);
+    
+    return out.overflow ? 0 : out.len;
+}
+
+size_t PushsaferNotifier::renderNotification(const PushNotification& notification) {
+    PostWriter out(postBuffer, sizeof(postBuffer));
     
-    // Expire (for priority 2)
-    if (notification.expire > 0) {
-        postData += "&ex=" + String(notification.expire);
+    // API Key, Title, Message (required)
+    out.raw("k=");
+    out.raw(apiKey.c_str());
+    if (notification.title.length() > 0) {
+        out.raw("&t=");
+        out.encoded(notification.title.c_str());
+    }
+    if (notification.message.length() > 0) {
+        out.raw("&m=");
+        out.encoded(notification.message.c_str());
     }
+    out.options(notification.priority, notification.sound, notification.icon,
+                notification.iconColor.c_str(), notification.device.c_str(),
+                notification.vibration, notification.timeToLive,
+                notification.retry, notification.expire);
     
-    return postData;
+    return out.overflow ? 0 : out.len;
 }
 
-bool PushsaferNotifier::sendHTTPRequest(String postData) {
+bool PushsaferNotifier::sendHTTPRequest(size_t length) {
+    if (length == 0) {
+        LOG_WARN("[Pushsafer] ✗ Body exceeds PUSHSAFER_POST_SIZE, not sent");
+        return false;
+    }
+    
     if (!isReady()) {
-        Serial.println("[Pushsafer] Not ready to send!");
+        LOG_WARN("[Pushsafer] Not ready to send!");
+        return false;
+    }
+    
+    LOG_INFO("[Pushsafer] Sending notification...");
+    
+    if (!connectTls()) {
         return false;
     }
     
+    // HTTPClient dùng kết nối vừa mở; không keep-alive
     HTTPClient http;
-    http.begin(apiUrl);
+    http.setReuse(false);
+    http.begin(tlsClient, apiUrl);
     http.addHeader("Content-Type", "application/x-www-form-urlencoded");
+    int httpCode = http.POST((uint8_t*)postBuffer, length);
     
-    Serial.println("[Pushsafer] Sending notification...");
+    String response;
+    if (httpCode > 0) {
+        response = http.getString();
+        LOG_DEBUG("[Pushsafer] HTTP %d: %s", httpCode, logCopy(response));
+    }
     
-    int httpCode = http.POST(postData);
+    // Đóng ngay: không giữ socket / TLS context khi rảnh
+    http.end();
+    tlsClient.stop();
     
-    if (httpCode > 0) {
-        String response = http.getString();
-        Serial.print("[Pushsafer] HTTP Code: ");
-        Serial.println(httpCode);
-        Serial.print("[Pushsafer] Response: ");
-        Serial.println(response);
-        
-        http.end();
-        
-        // Check if successful
-        if (response.indexOf("\"status\":1") > 0 || httpCode == 200) {
-            Serial.println("[Pushsafer] ✓ Notification sent successfully!");
-            lastSendTime = millis();
-            sendCount++;
-            return true;
-        } else {
-            Serial.println("[Pushsafer] ✗ API returned error");
-            return false;
-        }
+    if (httpCode <= 0) {
+        LOG_WARN("[Pushsafer] ✗ HTTP request failed: %d", httpCode);
+        return false;
+    }
+    
+    // Check if successful
+    if (response.indexOf("\"status\":1") > 0 || httpCode == 200) {
+        LOG_INFO("[Pushsafer] ✓ Notification sent successfully!");
+        lastSendTime = millis();
+        sendCount++;
+        return true;
     } else {
-        Serial.print("[Pushsafer] ✗ HTTP request failed: ");
-        Serial.println(httpCode);
-        http.end();
+        LOG_WARN("[Pushsafer] ✗ API returned error");
         return false;
     }
 }
@@ -236,224 +395,133 @@ bool PushsaferNotifier::send(String title, String message, int priority) {
     return sendNotification(notif);
 }
 
-bool PushsaferNotifier::sendNotification(PushNotification notification) {
-    String postData = buildPostData(notification);
-    return sendHTTPRequest(postData);
+bool PushsaferNotifier::sendNotification(const PushNotification& notification) {
+    return sendHTTPRequest(renderNotification(notification));
 }
 
 // ============================================
-// CRITICAL NOTIFICATIONS - PRIORITY 2
+// GARAGE NOTIFICATIONS (NOTIFY_CATALOG)
 // ============================================
 
-bool PushsaferNotifier::sendIntrusionAlert(bool pirDetected, bool ultrasonicDetected) {
-    Serial.println("[Pushsafer] Sending INTRUSION alert!");
-    
-    String details = "PIR: ";
-    details += pirDetected ? "YES" : "NO";
-    details += ", Ultrasonic: ";
-    details += ultrasonicDetected ? "YES" : "NO";
-    
-    PushNotification notif;
-    notif.title = "🚨 ĐỘT NHẬP!";
-    notif.message = "Phát hiện người trong garage đã đóng! " + details;
-    notif.priority = PRIORITY_EMERGENCY;
-    notif.sound = SOUND_SIREN;
-    notif.icon = ICON_SECURITY;
-    notif.iconColor = "#FF0000";
-    notif.vibration = VIBRATION_HIGH;
-    notif.timeToLive = 60;    // 60 phút
-    notif.retry = 60;         // Retry mỗi 60s
-    notif.expire = 3600;      // Hết hạn sau 1 giờ
-    notif.device = "a";
-    
-    return sendNotification(notif);
+bool PushsaferNotifier::notify(NotifyId id, std::initializer_list<NotifyArg> args) {
+    return notify(id, args.begin(), args.size());
 }
 
-bool PushsaferNotifier::sendFireAlert(float temperature, int smokeLevel, float humidity) {
-    Serial.println("[Pushsafer] Sending FIRE alert!");
-    
-    String details = "Nhiệt độ: " + String(temperature, 1) + "°C, ";
-    details += "Khói: " + String(smokeLevel) + ", ";
-    details += "Độ ẩm: " + String(humidity, 1) + "%";
+bool PushsaferNotifier::notify(NotifyId id, const NotifyArg* args, size_t argCount) {
+    if (id >= NOTIFY_COUNT) {
+        return false;
+    }
     
-    PushNotification notif;
-    notif.title = "🔥 HỎA HOẠN!";
-    notif.message = "Phát hiện cháy trong garage! " + details + " Gọi 114 ngay!";
-    notif.priority = PRIORITY_EMERGENCY;
-    notif.sound = SOUND_ALARM;
-    notif.icon = ICON_FIRE;
-    notif.iconColor = "#FF6600";
-    notif.vibration = VIBRATION_HIGH;
-    notif.timeToLive = 30;
-    notif.retry = 60;
-    notif.expire = 1800;      // 30 phút
-    notif.device = "a";
+    const NotifyTemplate& tpl = NOTIFY_CATALOG[id];
+    if (argCount != tpl.argCount) {
+        LOG_WARN("[Pushsafer] %s expects %u args, got %u", tpl.name, tpl.argCount, (unsigned)argCount);
+        return false;
+    }
     
-    return sendNotification(notif);
+    LOG_INFO("[Pushsafer] Sending %s notification", tpl.name);
+    return sendHTTPRequest(renderTemplate(id, args, argCount));
 }
 
 // ============================================
-// HIGH PRIORITY NOTIFICATIONS - PRIORITY 1
+// GỬI BẤT ĐỒNG BỘ
 // ============================================
 
-bool PushsaferNotifier::sendVehicleDetected(float distance) {
-    Serial.println("[Pushsafer] Sending vehicle detection!");
-    
-    PushNotification notif;
-    notif.title = "🚗 Xe đang chờ";
-    notif.message = "Phát hiện xe trước cửa garage (" + String(distance, 1) + " cm)";
-    notif.priority = PRIORITY_HIGH;
-    notif.sound = SOUND_ALARM;
-    notif.icon = ICON_CAR;
-    notif.iconColor = "#0066FF";
-    notif.vibration = VIBRATION_MEDIUM;
-    notif.timeToLive = 5;     // 5 phút
-    notif.retry = 0;
-    notif.expire = 0;
-    notif.device = "a";
-    
-    return sendNotification(notif);
-}
-
-bool PushsaferNotifier::sendHighTemperature(float temperature) {
-    Serial.println("[Pushsafer] Sending high temperature warning!");
-    
-    PushNotification notif;
-    notif.title = "🌡️ Cảnh báo nhiệt độ";
-    notif.message = "Nhiệt độ cao bất thường: " + String(temperature, 1) + "°C. Kiểm tra garage ngay!";
-    notif.priority = PRIORITY_HIGH;
-    notif.sound = SOUND_ALARM;
-    notif.icon = ICON_WARNING;
-    notif.iconColor = "#FFA500";
-    notif.vibration = VIBRATION_MEDIUM;
-    notif.timeToLive = 0;
-    notif.retry = 0;
-    notif.expire = 0;
-    notif.device = "a";
-    
-    return sendNotification(notif);
-}
-
-bool PushsaferNotifier::sendHighSmoke(int smokeLevel) {
-    Serial.println("[Pushsafer] Sending high smoke warning!");
+bool PushsaferNotifier::startTask() {
+    if (requestQueue != nullptr) return true;
     
-    PushNotification notif;
-    notif.title = "💨 Cảnh báo khói";
-    notif.message = "Mức khói cao: " + String(smokeLevel) + " ppm. Kiểm tra garage ngay!";
-    notif.priority = PRIORITY_HIGH;
-    notif.sound = SOUND_ALARM;
-    notif.icon = ICON_WARNING;
-    notif.iconColor = "#808080";
-    notif.vibration = VIBRATION_MEDIUM;
-    notif.timeToLive = 0;
-    notif.retry = 0;
-    notif.expire = 0;
-    notif.device = "a";
+    QueueHandle_t requests = xQueueCreate(PUSHSAFER_QUEUE_SIZE, sizeof(PushRequest));
+    QueueHandle_t results = xQueueCreate(PUSHSAFER_QUEUE_SIZE, sizeof(PushResult));
+    if (requests == nullptr || results == nullptr) {
+        LOG_ERROR("[Pushsafer] ✗ No memory for the send queue, sending from loop()");
+        return false;
+    }
     
-    return sendNotification(notif);
+    resultQueue = results;
+    requestQueue = requests;
+    if (xTaskCreate(sendTask, "pushsafer", PUSHSAFER_TASK_STACK, this,
+                    PUSHSAFER_TASK_PRIORITY, nullptr) != pdPASS) {
+        LOG_ERROR("[Pushsafer] ✗ No memory for the send task, sending from loop()");
+        vQueueDelete(requestQueue);
+        requestQueue = nullptr;
+        return false;
+    }
+    return true;
 }
 
-bool PushsaferNotifier::sendAlarmActivated(const char* reason) {
-    Serial.println("[Pushsafer] Sending alarm activated!");
-    
-    PushNotification notif;
-    notif.title = "⚠️ Báo động bật";
-    notif.message = "Báo động garage đã BẬT: " + String(reason);
-    notif.priority = PRIORITY_HIGH;
-    notif.sound = SOUND_ALARM;
-    notif.icon = ICON_ERROR;
-    notif.iconColor = "#FF0000";
-    notif.vibration = VIBRATION_HIGH;
-    notif.timeToLive = 0;
-    notif.retry = 0;
-    notif.expire = 0;
-    notif.device = "a";
+bool PushsaferNotifier::post(NotifyId id, std::initializer_list<NotifyArg> args, uint8_t tag) {
+    if (id >= NOTIFY_COUNT || args.size() > NOTIFY_MAX_ARGS) return false;
+    
+    // Không có task: gửi ngay, kết quả vẫn qua takeResult()
+    if (requestQueue == nullptr) {
+        PushResult result;
+        result.id = id;
+        result.tag = tag;
+        result.ok = notify(id, args);
+        result.doneMicros = micros();
+        if (resultQueue != nullptr) xQueueSend(resultQueue, &result, 0);
+        return result.ok;
+    }
     
-    return sendNotification(notif);
+    if (!isReady()) return false;
+    
+    PushRequest request;
+    request.id = id;
+    request.argCount = args.size();
+    request.tag = tag;
+    size_t n = 0;
+    for (const NotifyArg& arg : args) request.args[n++] = arg;
+    
+    bool urgent = NOTIFY_CATALOG[id].priority >= PRIORITY_EMERGENCY;
+    BaseType_t queued = urgent ? xQueueSendToFront(requestQueue, &request, 0)
+                               : xQueueSend(requestQueue, &request, 0);
+    if (queued != pdTRUE) {
+        queueDropped++;
+        LOG_WARN("[Pushsafer] ✗ Send queue full, %s dropped", NOTIFY_CATALOG[id].name);
+        return false;
+    }
+    return true;
 }
 
-// ============================================
-// NORMAL PRIORITY NOTIFICATIONS - PRIORITY 0
-// ============================================
-
-bool PushsaferNotifier::sendDoorOpened(const char* reason) {
-    Serial.println("[Pushsafer] Sending door opened notification");
-    
-    PushNotification notif;
-    notif.title = "🚪 Cửa garage";
-    notif.message = "Cửa đã mở: " + String(reason);
-    notif.priority = PRIORITY_NORMAL;
-    notif.sound = SOUND_POSITIVE;
-    notif.icon = ICON_HOME;
-    notif.iconColor = "#00FF00";
-    notif.vibration = VIBRATION_LOW;
-    notif.timeToLive = 0;
-    notif.retry = 0;
-    notif.expire = 0;
-    notif.device = "a";
+bool PushsaferNotifier::prewarm() {
+    // Không có task: bỏ qua, không bắt tay trong loop()
+    if (requestQueue == nullptr || !isReady()) return false;
     
-    return sendNotification(notif);
+    PushRequest request;
+    request.id = NOTIFY_COUNT;
+    request.argCount = 0;
+    request.tag = 0;
+    return xQueueSend(requestQueue, &request, 0) == pdTRUE;
 }
 
-bool PushsaferNotifier::sendDoorClosed(const char* reason) {
-    Serial.println("[Pushsafer] Sending door closed notification");
-    
-    PushNotification notif;
-    notif.title = "🚪 Cửa garage";
-    notif.message = "Cửa đã đóng: " + String(reason);
-    notif.priority = PRIORITY_NORMAL;
-    notif.sound = SOUND_POSITIVE;
-    notif.icon = ICON_HOME;
-    notif.iconColor = "#0000FF";
-    notif.vibration = VIBRATION_LOW;
-    notif.timeToLive = 0;
-    notif.retry = 0;
-    notif.expire = 0;
-    notif.device = "a";
-    
-    return sendNotification(notif);
+bool PushsaferNotifier::takeResult(PushResult& result) {
+    return resultQueue != nullptr && xQueueReceive(resultQueue, &result, 0) == pdTRUE;
 }
 
-bool PushsaferNotifier::sendAlarmDeactivated(const char* source) {
-    Serial.println("[Pushsafer] Sending alarm deactivated");
-    
-    PushNotification notif;
-    notif.title = "✅ Báo động tắt";
-    notif.message = "Báo động đã tắt bởi: " + String(source);
-    notif.priority = PRIORITY_NORMAL;
-    notif.sound = SOUND_POSITIVE;
-    notif.icon = ICON_SUCCESS;
-    notif.iconColor = "#00FF00";
-    notif.vibration = VIBRATION_LOW;
-    notif.timeToLive = 0;
-    notif.retry = 0;
-    notif.expire = 0;
-    notif.device = "a";
-    
-    return sendNotification(notif);
+void PushsaferNotifier::sendTask(void* param) {
+    ((PushsaferNotifier*)param)->runSendTask();
 }
 
-// ============================================
-// LOW PRIORITY NOTIFICATIONS - PRIORITY -1
-// ============================================
-
-bool PushsaferNotifier::sendSystemOnline() {
-    Serial.println("[Pushsafer] Sending system online");
-    
-    PushNotification notif;
-    notif.title = "💡 Hệ thống garage";
-    notif.message = "Hệ thống garage thông minh đã online";
-    notif.priority = PRIORITY_LOW;
-    notif.sound = SOUND_SILENT;
-    notif.icon = ICON_INFO;
-    notif.iconColor = "#0066FF";
-    notif.vibration = VIBRATION_LOW;
-    notif.timeToLive = 0;
-    notif.retry = 0;
-    notif.expire = 0;
-    notif.device = "a";
-    
-    return sendNotification(notif);
+void PushsaferNotifier::runSendTask() {
+    PushRequest request;
+    for (;;) {
+        if (xQueueReceive(requestQueue, &request, portMAX_DELAY) != pdTRUE) continue;
+        
+        if (request.id >= NOTIFY_COUNT) {
+            warmUpTls();
+            continue;
+        }
+        
+        PushResult result;
+        result.id = request.id;
+        result.tag = request.tag;
+        result.ok = notify(request.id, request.args, request.argCount);
+        result.doneMicros = micros();
+        
+        // loop() đọc mỗi vòng; đầy thì chỉ mất số đo latency
+        if (xQueueSend(resultQueue, &result, 0) != pdTRUE) {
+            LOG_WARN("[Pushsafer] Result queue full, %s outcome lost", NOTIFY_CATALOG[request.id].name);
+        }
+    }
 }
 
 // ============================================
@@ -461,7 +529,7 @@ bool PushsaferNotifier::sendSystemOnline() {
 // ============================================
 
 bool PushsaferNotifier::sendTest() {
-    return send("Test Notification", "Hệ thống thông báo garage hoạt động bình thường");
+    return notify(NOTIFY_TEST);
 }
 
 int PushsaferNotifier::getSendCount() {
@@ -3,7 +3,13 @@
 #define PUSHSAFER_NOTIFIER_H
 
 #include <Arduino.h>
+#include "ResumableTlsClient.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <initializer_list>
 #include "config.h"
+#include "Logger.h"
 
 // ============================================
 // PRIORITY LEVELS
@@ -63,11 +69,172 @@ struct PushNotification {
     String device;       // "a" = all devices
 };
 
+// ============================================
+// NOTIFICATION CATALOGUE
+// ============================================
+
+enum NotifyId : uint8_t {
+    // Critical (Priority 2)
+    NOTIFY_INTRUSION,
+    NOTIFY_FIRE_ALERT,
+    NOTIFY_EXTINGUISHER,
+    // High priority (Priority 1)
+    NOTIFY_VEHICLE_DETECTED,
+    NOTIFY_HIGH_TEMPERATURE,
+    NOTIFY_HIGH_SMOKE,
+    NOTIFY_ALARM_ACTIVATED,
+    // Normal priority (Priority 0)
+    NOTIFY_DOOR_OPENED,
+    NOTIFY_DOOR_CLOSED,
+    NOTIFY_ALARM_DEACTIVATED,
+    // Low priority (Priority -1)
+    NOTIFY_SYSTEM_ONLINE,
+    NOTIFY_TEST,
+    NOTIFY_COUNT
+};
+
+// Mẫu thông báo - nằm trong flash, không copy khi gửi.
+// "{}" trong title/message được thay bằng tham số theo thứ tự.
+#define NOTIFY_MAX_ARGS     3
+
+struct NotifyTemplate {
+    NotifyId id;
+    const char* name;        // cho log
+    const char* title;
+    const char* message;
+    uint8_t argCount;        // số "{}" trong title + message
+    int8_t priority;
+    uint8_t sound;
+    uint8_t icon;
+    const char* iconColor;
+    uint8_t vibration;
+    uint16_t timeToLive;     // minutes (0 = no expire)
+    uint16_t retry;          // seconds (for priority 2)
+    uint16_t expire;         // seconds (for priority 2)
+};
+
+static constexpr NotifyTemplate NOTIFY_CATALOG[] = {
+    { NOTIFY_INTRUSION, "INTRUSION", "🚨 ĐỘT NHẬP!",
+      "Phát hiện người trong garage đã đóng! PIR: {}, Ultrasonic: {}", 2,
+      PRIORITY_EMERGENCY, SOUND_SIREN, ICON_SECURITY, "#FF0000", VIBRATION_HIGH, 60, 60, 3600 },
+    { NOTIFY_FIRE_ALERT, "FIRE", "🔥 HỎA HOẠN!",
+      "Phát hiện cháy trong garage! Nhiệt độ: {}°C, Khói: {}, Độ ẩm: {}% Gọi 114 ngay!", 3,
+      PRIORITY_EMERGENCY, SOUND_ALARM, ICON_FIRE, "#FF6600", VIBRATION_HIGH, 30, 60, 1800 },
+    { NOTIFY_EXTINGUISHER, "EXTINGUISHER", "Fire Extinguisher Activated",
+      "Servo chữa cháy đã được kích hoạt tự động", 0,
+      PRIORITY_EMERGENCY, SOUND_ALARM, ICON_WARNING, "", VIBRATION_HIGH, 0, 0, 0 },
+    { NOTIFY_VEHICLE_DETECTED, "VEHICLE", "🚗 Xe đang chờ",
+      "Phát hiện xe trước cửa garage ({} cm)", 1,
+      PRIORITY_HIGH, SOUND_ALARM, ICON_CAR, "#0066FF", VIBRATION_MEDIUM, 5, 0, 0 },
+    { NOTIFY_HIGH_TEMPERATURE, "HIGH_TEMP", "🌡️ Cảnh báo nhiệt độ",
+      "Nhiệt độ cao bất thường: {}°C. Kiểm tra garage ngay!", 1,
+      PRIORITY_HIGH, SOUND_ALARM, ICON_WARNING, "#FFA500", VIBRATION_MEDIUM, 0, 0, 0 },
+    { NOTIFY_HIGH_SMOKE, "HIGH_SMOKE", "💨 Cảnh báo khói",
+      "Mức khói cao: {} ppm. Kiểm tra garage ngay!", 1,
+      PRIORITY_HIGH, SOUND_ALARM, ICON_WARNING, "#808080", VIBRATION_MEDIUM, 0, 0, 0 },
+    { NOTIFY_ALARM_ACTIVATED, "ALARM_ON", "⚠️ Báo động bật",
+      "Báo động garage đã BẬT: {}", 1,
+      PRIORITY_HIGH, SOUND_ALARM, ICON_ERROR, "#FF0000", VIBRATION_HIGH, 0, 0, 0 },
+    { NOTIFY_DOOR_OPENED, "DOOR_OPENED", "🚪 Cửa garage",
+      "Cửa đã mở: {}", 1,
+      PRIORITY_NORMAL, SOUND_POSITIVE, ICON_HOME, "#00FF00", VIBRATION_LOW, 0, 0, 0 },
+    { NOTIFY_DOOR_CLOSED, "DOOR_CLOSED", "🚪 Cửa garage",
+      "Cửa đã đóng: {}", 1,
+      PRIORITY_NORMAL, SOUND_POSITIVE, ICON_HOME, "#0000FF", VIBRATION_LOW, 0, 0, 0 },
+    { NOTIFY_ALARM_DEACTIVATED, "ALARM_OFF", "✅ Báo động tắt",
+      "Báo động đã tắt bởi: {}", 1,
+      PRIORITY_NORMAL, SOUND_POSITIVE, ICON_SUCCESS, "#00FF00", VIBRATION_LOW, 0, 0, 0 },
+    { NOTIFY_SYSTEM_ONLINE, "ONLINE", "💡 Hệ thống garage",
+      "Hệ thống garage thông minh đã online", 0,
+      PRIORITY_LOW, SOUND_SILENT, ICON_INFO, "#0066FF", VIBRATION_LOW, 0, 0, 0 },
+    { NOTIFY_TEST, "TEST", "Test Notification",
+      "Hệ thống thông báo garage hoạt động bình thường", 0,
+      PRIORITY_NORMAL, SOUND_AHEM, ICON_INFO, "", VIBRATION_MEDIUM, 0, 0, 0 },
+};
+
+// Kiểm tra lúc biên dịch: thứ tự theo NotifyId, argCount khớp số "{}"
+constexpr uint8_t countPlaceholders(const char* s) {
+    return *s == 0 ? 0
+         : (s[0] == '{' && s[1] == '}') ? 1 + countPlaceholders(s + 2)
+         : countPlaceholders(s + 1);
+}
+
+constexpr bool catalogueValid(uint8_t i) {
+    return i >= NOTIFY_COUNT ||
+           (NOTIFY_CATALOG[i].id == i &&
+            countPlaceholders(NOTIFY_CATALOG[i].title) +
+            countPlaceholders(NOTIFY_CATALOG[i].message) == NOTIFY_CATALOG[i].argCount &&
+            NOTIFY_CATALOG[i].argCount <= NOTIFY_MAX_ARGS &&
+            catalogueValid(i + 1));
+}
+
+static_assert(sizeof(NOTIFY_CATALOG) / sizeof(NOTIFY_CATALOG[0]) == NOTIFY_COUNT,
+              "NOTIFY_CATALOG needs one entry per NotifyId");
+static_assert(catalogueValid(0), "NOTIFY_CATALOG out of order or argCount mismatch");
+
+// Tham số có kiểu cho "{}" - chuỗi chỉ được tham chiếu, không copy
+// (chỉ dùng chuỗi hằng khi gửi qua queue)
+struct NotifyArg {
+    enum Type : uint8_t { ARG_INT, ARG_FLOAT, ARG_TEXT, ARG_FLAG };
+    Type type;
+    union {
+        long i;
+        float f;             // in với 1 chữ số thập phân
+        const char* s;
+        bool b;              // YES / NO
+    };
+    
+    NotifyArg() : type(ARG_INT), i(0) {}
+    NotifyArg(int v) : type(ARG_INT), i(v) {}
+    NotifyArg(long v) : type(ARG_INT), i(v) {}
+    NotifyArg(float v) : type(ARG_FLOAT), f(v) {}
+    NotifyArg(double v) : type(ARG_FLOAT), f(v) {}
+    NotifyArg(const char* v) : type(ARG_TEXT), s(v ? v : "") {}
+    NotifyArg(bool v) : type(ARG_FLAG), b(v) {}
+};
+
+// ============================================
+// SEND QUEUE
+// ============================================
+
+// Một yêu cầu gửi cho task Pushsafer (copy nguyên vào queue)
+struct PushRequest {
+    NotifyId id;             // NOTIFY_COUNT = chỉ bắt tay TLS (prewarm)
+    uint8_t argCount;
+    uint8_t tag;             // trả lại trong PushResult (vd. TraceId)
+    NotifyArg args[NOTIFY_MAX_ARGS];
+};
+
+// Kết quả, loop() lấy bằng takeResult()
+struct PushResult {
+    NotifyId id;
+    uint8_t tag;
+    bool ok;
+    unsigned long doneMicros;    // lúc gửi xong (micros())
+};
+
+// ============================================
+// TLS STATISTICS
+// ============================================
+
+struct TlsStats {
+    unsigned long handshakes;        // full handshakes (no session, or the server refused it)
+    unsigned long resumed;           // abbreviated handshakes, saved session accepted
+    unsigned long failures;          // connects that did not complete
+    unsigned long lastHandshakeMs;   // last connect, either kind
+    unsigned long maxHandshakeMs;    // full handshakes only
+    unsigned long totalHandshakeMs;  // full handshakes only
+    unsigned long totalResumedMs;
+};
+
 // ============================================
 // CLASS PUSHSAFER NOTIFIER
 // ============================================
 
 class PushsaferNotifier {
+    // Bộ benchmark đo renderTemplate()/renderNotification()
+    friend class MicroBench;
+    
 private:
     String apiKey;
     String apiUrl;
@@ -75,14 +242,39 @@ private:
     unsigned long lastSendTime;
     int sendCount;
     
-    // Build POST data từ struct
-    String buildPostData(PushNotification notification);
+    // Kết nối TLS, mở cho mỗi request và đóng ngay sau response.
+    // Session được giữ lại để lần kết nối sau bắt tay rút gọn
+    ResumableTlsClient tlsClient;
+    String apiHost;
+    uint16_t apiPort;
+    TlsStats tlsStats;
+    
+    // Tách host/port từ apiUrl
+    void parseApiUrl();
     
-    // URL encode helper
-    String urlEncode(String str);
+    // Mở kết nối TLS mới, đo thời gian handshake (đầy đủ / rút gọn)
+    bool connectTls();
     
-    // Send HTTP POST request
-    bool sendHTTPRequest(String postData);
+    // Bắt tay rồi đóng ngay, chỉ để có session cho lần gửi sau
+    bool warmUpTls();
+    
+    // Body của request, render trực tiếp vào đây (không qua String)
+    char postBuffer[PUSHSAFER_POST_SIZE];
+    
+    
+    // Render vào postBuffer, trả về độ dài (0 = tràn buffer)
+    size_t renderTemplate(NotifyId id, const NotifyArg* args, size_t argCount);
+    size_t renderNotification(const PushNotification& notification);
+    
+    // Send HTTP POST request (postBuffer)
+    bool sendHTTPRequest(size_t length);
+    
+    // Task gửi: lấy PushRequest từ requestQueue, trả PushResult
+    QueueHandle_t requestQueue;
+    QueueHandle_t resultQueue;
+    unsigned long queueDropped;
+    static void sendTask(void* param);
+    void runSendTask();
     
 public:
     // Constructor
@@ -96,6 +288,10 @@ public:
     // Kiểm tra ready
     bool isReady();
     
+    // Thống kê TLS
+    const TlsStats& getTlsStats();
+    void printTlsStats();
+    
     // ============================================
     // HÀM GỬI CƠ BẢN
     // ============================================
@@ -107,53 +303,36 @@ public:
     bool send(String title, String message, int priority);
     
     // Gửi đầy đủ tham số
-    bool sendNotification(PushNotification notification);
+    bool sendNotification(const PushNotification& notification);
     
     // ============================================
-    // GARAGE NOTIFICATIONS - CRITICAL (Priority 2)
+    // GARAGE NOTIFICATIONS (NOTIFY_CATALOG)
     // ============================================
     
-    // Đột nhập
-    bool sendIntrusionAlert(bool pirDetected, bool ultrasonicDetected);
-    
-    // Hỏa hoạn
-    bool sendFireAlert(float temperature, int smokeLevel, float humidity);
+    // notify(NOTIFY_FIRE_ALERT, {temperature, smokeLevel, humidity})
+    // Gửi ngay (chặn tới khi có response). Như send*(): chỉ gọi từ một
+    // task - task gửi, hoặc loop() khi không có task
+    bool notify(NotifyId id, std::initializer_list<NotifyArg> args = {});
+    bool notify(NotifyId id, const NotifyArg* args, size_t argCount);
     
     // ============================================
-    // GARAGE NOTIFICATIONS - HIGH PRIORITY (Priority 1)
+    // GỬI BẤT ĐỒNG BỘ (task riêng, không chặn loop())
     // ============================================
     
-    // Phát hiện xe trước cửa
-    bool sendVehicleDetected(float distance);
-    
-    // Cảnh báo nhiệt độ cao
-    bool sendHighTemperature(float temperature);
-    
-    // Cảnh báo khói cao
-    bool sendHighSmoke(int smokeLevel);
+    // Tạo queue + task gửi. Gọi sau begin()
+    bool startTask();
     
-    // Báo động bật
-    bool sendAlarmActivated(const char* reason);
-    
-    // ============================================
-    // GARAGE NOTIFICATIONS - NORMAL PRIORITY (Priority 0)
-    // ============================================
+    // Xếp hàng một notification; false = queue đầy hoặc chưa ready.
+    // PRIORITY_EMERGENCY vào đầu queue, vượt lên thông báo thường (vd.
+    // "online" lúc boot). Không có task (hết RAM) thì gửi ngay như notify()
+    bool post(NotifyId id, std::initializer_list<NotifyArg> args = {}, uint8_t tag = 0);
     
-    // Cửa mở
-    bool sendDoorOpened(const char* reason);
-    
-    // Cửa đóng
-    bool sendDoorClosed(const char* reason);
-    
-    // Báo động tắt
-    bool sendAlarmDeactivated(const char* source);
-    
-    // ============================================
-    // GARAGE NOTIFICATIONS - LOW PRIORITY (Priority -1)
-    // ============================================
+    // Lấy một kết quả đã xong, không chờ. Gọi từ loop()
+    bool takeResult(PushResult& result);
     
-    // Hệ thống online
-    bool sendSystemOnline();
+    // Xếp hàng một lần bắt tay TLS (lúc boot, sau khi WiFi kết nối lại)
+    // để alert đầu tiên resume session thay vì bắt tay đầy đủ. Cần task
+    bool prewarm();
     
     // ============================================
     // TIỆN ÍCH
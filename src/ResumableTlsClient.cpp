@@ -0,0 +1,66 @@
+// ResumableTlsClient.cpp
+#include "ResumableTlsClient.h"
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+ResumableTlsClient::ResumableTlsClient() {
+  mbedtls_ssl_session_init(&session);
+  sessionSaved = false;
+  lastResumed = false;
+}
+
+ResumableTlsClient::~ResumableTlsClient() {
+  mbedtls_ssl_session_free(&session);
+}
+
+// ============================================
+// CONNECT
+// ============================================
+
+int ResumableTlsClient::connect(const char* host, uint16_t port) {
+  lastResumed = false;
+
+  // TCP connect + mbedtls_ssl_setup(), handshake held back
+  setPlainStart();
+  if (!WiFiClientSecure::connect(host, port)) return 0;
+
+  // A server resuming the session echoes its ID in the ServerHello;
+  // on a full handshake it picks a new one
+  unsigned char offeredId[sizeof(session.MBEDTLS_PRIVATE(id))];
+  size_t offeredLength = 0;
+  if (sessionSaved && mbedtls_ssl_set_session(&sslclient->ssl_ctx, &session) == 0) {
+    offeredLength = session.MBEDTLS_PRIVATE(id_len);
+    memcpy(offeredId, session.MBEDTLS_PRIVATE(id), offeredLength);
+  }
+
+  if (!startTLS()) {
+    // Should fall back to a full handshake, but a server choking on
+    // the offer must not fail every later connect too
+    if (offeredLength > 0) clearSession();
+    return 0;
+  }
+
+  if (saveSession() && offeredLength > 0) {
+    lastResumed = session.MBEDTLS_PRIVATE(id_len) == offeredLength &&
+                  memcmp(session.MBEDTLS_PRIVATE(id), offeredId, offeredLength) == 0;
+  }
+  return 1;
+}
+
+// ============================================
+// SESSION
+// ============================================
+
+bool ResumableTlsClient::saveSession() {
+  clearSession();
+  sessionSaved = mbedtls_ssl_get_session(&sslclient->ssl_ctx, &session) == 0;
+  return sessionSaved;
+}
+
+void ResumableTlsClient::clearSession() {
+  mbedtls_ssl_session_free(&session);
+  mbedtls_ssl_session_init(&session);
+  sessionSaved = false;
+}
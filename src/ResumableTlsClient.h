@@ -0,0 +1,48 @@
+// ResumableTlsClient.h
+#ifndef RESUMABLE_TLS_CLIENT_H
+#define RESUMABLE_TLS_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+#include <mbedtls/ssl.h>
+
+// ============================================
+// CLASS RESUMABLE TLS CLIENT
+// ============================================
+// WiFiClientSecure that keeps the TLS session of its last connection
+// (mbedtls_ssl_get_session) and offers it on the next connect()
+// (mbedtls_ssl_set_session). A server that still knows the session ID
+// or accepts the ticket answers with an abbreviated handshake: no
+// certificate chain, no key exchange, a fraction of the CPU and radio
+// time. One that does not simply falls back to a full handshake.
+//
+// The session has to be set between mbedtls_ssl_setup() and the
+// handshake, which the stock connect() does in one go; setPlainStart()
+// and startTLS() (ESP32 core 3.x) split them.
+class ResumableTlsClient : public WiFiClientSecure {
+private:
+  mbedtls_ssl_session session;
+  bool sessionSaved;
+  bool lastResumed;
+
+  // Copy the session of the live connection, replacing the saved one
+  bool saveSession();
+
+public:
+  ResumableTlsClient();
+  ~ResumableTlsClient();
+
+  using WiFiClientSecure::connect;
+
+  // Full or abbreviated handshake; 1 = connected, 0 = failed
+  int connect(const char* host, uint16_t port) override;
+
+  // Whether the last successful connect() resumed the saved session
+  bool resumed() const { return lastResumed; }
+  bool hasSession() const { return sessionSaved; }
+
+  // Next connect() does a full handshake
+  void clearSession();
+};
+
+#endif
@@ -0,0 +1,263 @@
+// Scheduler.cpp
+#include "Scheduler.h"
+
+static_assert(SCHED_MAX_JOBS >= SCHED_FIXED_JOBS + BAY_MAX,
+              "every bay needs a job slot for its vehicle alert");
+
+enum JobState : uint8_t {
+  JOB_FREE,
+  JOB_WAITING,      // linked into a wheel slot
+  JOB_READY,        // expired, waiting to run in this tick
+  JOB_RUNNING,
+  JOB_CANCELLED     // cancelled while ready/running
+};
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+Scheduler::Scheduler() {
+  for (int16_t i = 0; i < SCHED_MAX_JOBS; i++) {
+    jobs[i].state = JOB_FREE;
+    jobs[i].generation = 0;
+    jobs[i].next = (i + 1 < SCHED_MAX_JOBS) ? i + 1 : -1;
+  }
+  for (int16_t s = 0; s < SCHED_WHEEL_SLOTS; s++) {
+    wheel[s] = -1;
+  }
+  freeHead = 0;
+  currentTick = 0;
+  tickBase = 0;
+  started = false;
+}
+
+// ============================================
+// WHEEL LISTS
+// ============================================
+
+void Scheduler::link(int16_t index) {
+  SchedulerJob& job = jobs[index];
+
+  // Expire on the first tick boundary at or after `due`
+  unsigned long delta = job.due - tickBase;
+  unsigned long ticks = (delta + SCHED_TICK_MS - 1) / SCHED_TICK_MS;
+  if (ticks == 0) ticks = 1;
+
+  job.slot = (currentTick + ticks) % SCHED_WHEEL_SLOTS;
+  job.rounds = (ticks - 1) / SCHED_WHEEL_SLOTS;
+  job.prev = -1;
+  job.next = wheel[job.slot];
+  if (job.next >= 0) jobs[job.next].prev = index;
+  wheel[job.slot] = index;
+  job.state = JOB_WAITING;
+}
+
+void Scheduler::unlink(int16_t index) {
+  SchedulerJob& job = jobs[index];
+
+  if (job.prev >= 0) {
+    jobs[job.prev].next = job.next;
+  } else {
+    wheel[job.slot] = job.next;
+  }
+  if (job.next >= 0) jobs[job.next].prev = job.prev;
+
+  job.next = -1;
+  job.prev = -1;
+  job.slot = -1;
+}
+
+void Scheduler::release(int16_t index) {
+  jobs[index].state = JOB_FREE;
+  jobs[index].generation++;
+  jobs[index].next = freeHead;
+  freeHead = index;
+}
+
+int16_t Scheduler::indexOf(JobId id) {
+  if (id < 0) return -1;
+  int16_t index = id & 0xFFFF;
+  uint16_t generation = (id >> 16) & 0x7FFF;
+
+  if (index >= SCHED_MAX_JOBS) return -1;
+  if (jobs[index].state == JOB_FREE) return -1;
+  if ((jobs[index].generation & 0x7FFF) != generation) return -1;
+  return index;
+}
+
+// ============================================
+// ADD / CANCEL
+// ============================================
+
+JobId Scheduler::add(const char* name, unsigned long delay, unsigned long period,
+                     JobFunction fn, void* context, unsigned long budget) {
+  if (fn == nullptr || freeHead < 0) return JOB_INVALID;
+
+  if (!started) {
+    tickBase = millis();
+    started = true;
+  }
+
+  int16_t index = freeHead;
+  freeHead = jobs[index].next;
+
+  SchedulerJob& job = jobs[index];
+  job.name = name;
+  job.fn = fn;
+  job.context = context;
+  job.period = period;
+  job.due = millis() + delay;
+  job.budget = budget;
+  job.runs = 0;
+  job.overruns = 0;
+  job.maxLateness = 0;
+  job.maxRuntime = 0;
+  link(index);
+
+  return ((JobId)(job.generation & 0x7FFF) << 16) | index;
+}
+
+JobId Scheduler::every(const char* name, unsigned long period, JobFunction fn,
+                       void* context, unsigned long budget) {
+  if (period == 0) return JOB_INVALID;
+  return add(name, period, period, fn, context, budget ? budget : period);
+}
+
+JobId Scheduler::after(const char* name, unsigned long delay, JobFunction fn, void* context) {
+  return add(name, delay, 0, fn, context, 0);
+}
+
+bool Scheduler::cancel(JobId id) {
+  int16_t index = indexOf(id);
+  if (index < 0) return false;
+
+  switch (jobs[index].state) {
+    case JOB_WAITING:
+      unlink(index);
+      release(index);
+      return true;
+    case JOB_READY:
+    case JOB_RUNNING:
+      jobs[index].state = JOB_CANCELLED;   // execute() frees it
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool Scheduler::isScheduled(JobId id) {
+  int16_t index = indexOf(id);
+  return index >= 0 && jobs[index].state != JOB_CANCELLED;
+}
+
+// ============================================
+// RUN
+// ============================================
+
+void Scheduler::execute(int16_t index, unsigned long now) {
+  SchedulerJob& job = jobs[index];
+
+  if (job.state == JOB_CANCELLED) {
+    release(index);
+    return;
+  }
+
+  job.state = JOB_RUNNING;
+  unsigned long lateness = now - job.due;
+  unsigned long start = millis();
+
+  job.fn(job.context);
+
+  unsigned long end = millis();
+  unsigned long runtime = end - start;
+  job.runs++;
+  if (lateness > job.maxLateness) job.maxLateness = lateness;
+  if (runtime > job.maxRuntime) job.maxRuntime = runtime;
+  if ((job.budget > 0 && runtime > job.budget) ||
+      (job.period > 0 && lateness >= job.period)) {
+    job.overruns++;
+  }
+
+  if (job.state == JOB_CANCELLED || job.period == 0) {
+    release(index);
+    return;
+  }
+
+  // Keep the cadence; skip periods that were missed entirely
+  job.due += job.period;
+  while ((long)(end - job.due) >= 0) {
+    job.due += job.period;
+  }
+  link(index);
+}
+
+void Scheduler::run() {
+  if (!started) return;
+
+  unsigned long now = millis();
+
+  while (now - tickBase >= SCHED_TICK_MS) {
+    tickBase += SCHED_TICK_MS;
+    currentTick++;
+
+    // Detach everything that expires on this tick before running any of
+    // it, so jobs may freely add/cancel other jobs.
+    int16_t slot = currentTick % SCHED_WHEEL_SLOTS;
+    int16_t ready = -1;
+    int16_t readyTail = -1;
+
+    int16_t i = wheel[slot];
+    while (i >= 0) {
+      int16_t next = jobs[i].next;
+      if (jobs[i].rounds > 0) {
+        jobs[i].rounds--;
+      } else {
+        unlink(i);
+        jobs[i].state = JOB_READY;
+        if (readyTail >= 0) {
+          jobs[readyTail].next = i;
+        } else {
+          ready = i;
+        }
+        readyTail = i;
+      }
+      i = next;
+    }
+
+    while (ready >= 0) {
+      int16_t next = jobs[ready].next;
+      jobs[ready].next = -1;
+      execute(ready, millis());
+      ready = next;
+    }
+  }
+}
+
+unsigned long Scheduler::nextWakeup() {
+  unsigned long now = millis();
+  unsigned long best = SCHED_IDLE_MAX;
+
+  for (int16_t i = 0; i < SCHED_MAX_JOBS; i++) {
+    if (jobs[i].state != JOB_WAITING) continue;
+
+    long remaining = (long)(jobs[i].due - now);
+    if (remaining <= 0) return 0;
+    if ((unsigned long)remaining < best) best = remaining;
+  }
+  return best;
+}
+
+// ============================================
+// UTILITIES
+// ============================================
+
+void Scheduler::printStats() {
+  LOG_INFO("[Scheduler] Jobs:");
+  for (int16_t i = 0; i < SCHED_MAX_JOBS; i++) {
+    const SchedulerJob& job = jobs[i];
+    if (job.state == JOB_FREE || job.period == 0) continue;
+
+    LOG_INFO("   %s: runs=%lu overruns=%lu maxLate=%lums maxRun=%lums",
+             job.name, job.runs, job.overruns, job.maxLateness, job.maxRuntime);
+  }
+}
@@ -0,0 +1,87 @@
+// Scheduler.h
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "Logger.h"
+
+typedef void (*JobFunction)(void* context);
+typedef int32_t JobId;          // -1 = invalid
+
+#define JOB_INVALID -1
+
+// ============================================
+// JOB
+// ============================================
+struct SchedulerJob {
+  const char* name;
+  JobFunction fn;
+  void* context;
+  unsigned long period;         // 0 = one-shot
+  unsigned long due;            // absolute millis()
+  unsigned long budget;         // ms; runtime above it counts as overrun
+  uint16_t rounds;              // wheel revolutions left
+  uint16_t generation;          // invalidates stale JobIds
+  int16_t slot;
+  int16_t next;
+  int16_t prev;
+  uint8_t state;
+
+  // Accounting
+  unsigned long runs;
+  unsigned long overruns;       // over budget or a whole period late
+  unsigned long maxLateness;    // ms after due
+  unsigned long maxRuntime;     // ms
+};
+
+// ============================================
+// CLASS SCHEDULER
+// ============================================
+// Cooperative scheduler on a hashed timer wheel: SCHED_WHEEL_SLOTS
+// buckets of SCHED_TICK_MS each, jobs further out than one revolution
+// carry a round counter. Insert and cancel are O(1) (intrusive doubly
+// linked bucket lists); run() visits one bucket per elapsed tick.
+// Jobs never fire before their due time.
+class Scheduler {
+private:
+  SchedulerJob jobs[SCHED_MAX_JOBS];
+  int16_t wheel[SCHED_WHEEL_SLOTS];
+  int16_t freeHead;
+  unsigned long currentTick;    // free-running tick counter
+  unsigned long tickBase;       // millis() at the start of currentTick
+  bool started;
+
+  JobId add(const char* name, unsigned long delay, unsigned long period,
+            JobFunction fn, void* context, unsigned long budget);
+  void link(int16_t index);
+  void unlink(int16_t index);
+  void release(int16_t index);
+  void execute(int16_t index, unsigned long now);
+  int16_t indexOf(JobId id);
+
+public:
+  Scheduler();
+
+  // Periodic job, first run after `period`. budget 0 = period.
+  JobId every(const char* name, unsigned long period, JobFunction fn,
+              void* context = nullptr, unsigned long budget = 0);
+
+  // One-shot job
+  JobId after(const char* name, unsigned long delay, JobFunction fn,
+              void* context = nullptr);
+
+  // Safe to call from inside the job itself
+  bool cancel(JobId id);
+  bool isScheduled(JobId id);
+
+  // Run everything that is due. Call from loop().
+  void run();
+
+  // ms until the next job is due (0 = overdue, SCHED_IDLE_MAX if none)
+  unsigned long nextWakeup();
+
+  void printStats();
+};
+
+#endif
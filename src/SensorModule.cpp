@@ -5,17 +5,24 @@
 // ULTRASONIC SENSOR
 // ============================================
 float readUltrasonic(int echoPin, int trigPin) {
+  return readUltrasonicMm(echoPin, trigPin) / 10.0;
+}
+
+// Sound travels 0.34 mm/us, half of it each way: mm = us * 17 / 100
+uint16_t readUltrasonicMm(int echoPin, int trigPin) {
+  const uint32_t maxMm = MAX_DISTANCE * 10;
+
   digitalWrite(trigPin, LOW);
   delayMicroseconds(2);
   digitalWrite(trigPin, HIGH);
   delayMicroseconds(10);
   digitalWrite(trigPin, LOW);
 
-  long duration = pulseIn(echoPin, HIGH, 30000);
-  if (duration == 0) return MAX_DISTANCE;
+  uint32_t duration = pulseIn(echoPin, HIGH, ULTRASONIC_TIMEOUT);
+  if (duration == 0) return maxMm;
 
-  float distance = (duration * 0.034) / 2.0;
-  return (distance > MAX_DISTANCE) ? MAX_DISTANCE : distance;
+  uint32_t mm = duration * 17 / 100;
+  return (mm > maxMm) ? maxMm : mm;
 }
 
 // ============================================
@@ -29,62 +36,40 @@ bool readPIR(int pirPin) {
 // GAS/SMOKE SENSOR
 // ============================================
 int readGasSensor(int gasPin) {
-  int raw = analogRead((gasPin));
-  return map(raw, 0, 4095, 0, 1000);
+  return gasCalibration.ppm(analogRead(gasPin), GAS_SMOKE);
 }
 
 // ============================================
 // TEMPERATURE SENSOR (DS18B20 analog)
 // ============================================
 float readTemperatureSensor(int tempPin) {
-  int rawValue = analogRead(tempPin);
-  return (rawValue / 4095.0) * 100.0;
-}
-
-
-// ============================================
-// SERVO CONTROL
-// ============================================
-void moveDoorServo(Servo& servo, int angle) {
-  servo.write(angle);
+  return readTemperatureCenti(tempPin) / 100.0;
 }
 
-void openDoor(Servo& servo) {
-  Serial.println("🚪 Opening door...");
-  for (int pos = 0; pos <= 160; pos += 5) {
-    servo.write(pos);
-    delay(15);
-  }
-  Serial.println("✓ Door opened");
+// 0..4095 -> 0..100.00 °C
+int16_t readTemperatureCenti(int tempPin) {
+  int32_t rawValue = analogRead(tempPin);
+  return (rawValue * 10000 + 2047) / 4095;
 }
 
-void closeDoor(Servo& servo) {
-  Serial.println("🚪 Closing door...");
-  for (int pos = 160; pos >= 0; pos -= 5) {
-    servo.write(pos);
-    delay(15);
-  }
-  Serial.println("✓ Door closed");
-}
 
 // ============================================
-// READ ALL SENSORS
+// ENVIRONMENT (DHT, gas, PIR)
 // ============================================
-SensorData readAllSensors(DHTesp& dht) {
+SensorData readEnvironment(DHTesp& dht) {
   SensorData data;
   data.timestamp = millis();
 
   // DHT22
-TempAndHumidity values = dht.getTempAndHumidity();
-
-data.temperatureDHT = values.temperature;
-data.humidity    = values.humidity;
+  TempAndHumidity values = dht.getTempAndHumidity();
 
+  data.temperatureDHT = values.temperature;
+  data.humidity    = values.humidity;
 
   // Other sensors
   data.smokeLevel = readGasSensor(GAS_SENSOR_PIN);
-  data.distanceOutside = readUltrasonic(ECHO_OUTSIDE_PIN, TRIG_OUTSIDE_PIN);
-  data.distanceInside = readUltrasonic(ECHO_INSIDE_PIN, TRIG_INSIDE_PIN);
+  data.distanceOutside = MAX_DISTANCE;
+  data.distanceInside = MAX_DISTANCE;
   data.pirMotion = readPIR(PIR_PIN);
 
   return data;
@@ -94,12 +79,8 @@ data.humidity    = values.humidity;
 // PRINT SENSOR DATA
 // ============================================
 void printSensorData(const SensorData& data) {
-  Serial.println("\n📊 ==================== SENSOR DATA ====================");
-  Serial.print("Temperature (DHT):  "); Serial.print(data.temperatureDHT, 1); Serial.println(" °C");
-  Serial.print("Humidity:           "); Serial.print(data.humidity, 1); Serial.println(" %");
-  Serial.print("Smoke Level:        "); Serial.print(data.smokeLevel); Serial.println(" ppm");
-  Serial.print("Distance (Outside): "); Serial.print(data.distanceOutside, 1); Serial.println(" cm");
-  Serial.print("Distance (Inside):  "); Serial.print(data.distanceInside, 1); Serial.println(" cm");
-  Serial.print("PIR Motion:         "); Serial.println(data.pirMotion ? "DETECTED" : "None");
-  Serial.println("========================================================\n");
+  LOG_INFO("📊 %.1f°C %.1f%% smoke=%dppm out=%.1fcm in=%.1fcm pir=%s",
+           data.temperatureDHT, data.humidity, data.smokeLevel,
+           data.distanceOutside, data.distanceInside,
+           data.pirMotion ? "DETECTED" : "None");
 }
\ No newline at end of file
@@ -3,9 +3,10 @@
 #define SENSOR_MODULE_H
 
 #include <Arduino.h>
-#include <ESP32Servo.h>
 #include <DHTesp.h>
 #include "config.h"
+#include "Logger.h"
+#include "GasCalibration.h"
 
 // ============================================
 // SENSOR DATA STRUCTURE
@@ -26,23 +27,20 @@ struct SensorData {
 
 // Ultrasonic Sensor
 float readUltrasonic(int echoPin, int trigPin);
+uint16_t readUltrasonicMm(int echoPin, int trigPin);
 
 // PIR Motion Sensor
 bool readPIR(int pirPin);
 
-// Gas/Smoke Sensor
+// Gas/Smoke Sensor (calibrated ppm, see GasCalibration)
 int readGasSensor(int gasPin);
 
 // Temperature Sensor (DS18B20 analog)
 float readTemperatureSensor(int tempPin);
+int16_t readTemperatureCenti(int tempPin);
 
-// Servo Control
-void moveDoorServo(Servo& servo, int angle);
-void openDoor(Servo& servo);
-void closeDoor(Servo& servo);
-
-// Read All Sensors
-SensorData readAllSensors(DHTesp& dht);
+// Read DHT, gas and PIR only - distances come from the bay registry
+SensorData readEnvironment(DHTesp& dht);
 
 // Print Sensor Data
 void printSensorData(const SensorData& data);
@@ -5,430 +5,1068 @@
 
 #include <WiFi.h>
 #include <PubSubClient.h>
+#include <ESP32Servo.h>
+#include <freertos/task.h>
 #include "config.h"
 #include "SensorModule.h"
 #include "PushsaferNotifier.h"
 #include "ThingSpeakLogger.h"
+#include "EventBus.h"
+#include "HistoryStore.h"
+#include "DashboardServer.h"
+#include "DeadbandPublisher.h"
+#include "BayRegistry.h"
+#include "Scheduler.h"
+#include "ApproachTracker.h"
+#include "PackedSample.h"
+#include "Logger.h"
+#include "LatencyTracer.h"
+#include "AlarmRules.h"
+#include "MicroBench.h"
+#include "BootSequence.h"
+#include "CommandParser.h"
+#if FLEET_SIM_ENABLED
+#include "FleetSimulator.h"
+#endif
 
 // Global Objects
 WiFiClient espClient;
 PubSubClient mqttClient(espClient);
-Servo servoDoor;
 Servo servoExtinguisher;
 DHTesp dht;
 PushsaferNotifier pushNotifier;
 ThingSpeakLogger cloudLogger;
+EventBus eventBus;
+HistoryStore history;
+DashboardServer dashboard;
+DeadbandPublisher sensorPublisher(mqttClient);
+BayRegistry bays;
+Scheduler scheduler;
+ApproachTracker approach;
+LatencyTracer tracer(mqttClient);
+AlarmRuleEngine alarmRules;
+MicroBench microBench(mqttClient);
+BootSequence bootSequence(mqttClient);
+#if FLEET_SIM_ENABLED
+FleetSimulator fleetSim;
+#endif
 
 // State Variables
-DoorState doorState = DOOR_CLOSED;
-bool vehicleDetectedOutside = false;
-unsigned long vehicleDetectedTime = 0;
-unsigned long lastMqttAttempt = 0;
-unsigned long lastSensorRead = 0;
-unsigned long lastThingSpeakUpload = 0;
-unsigned long lastDistanceCheck = 0;
 SensorData currentSensorData;
 AlarmState alarmState = ALARM_OFF;
+JobId flashJob = JOB_INVALID;
+JobId extinguisherJob = JOB_INVALID;
+JobId bootJobId = JOB_INVALID;
+JobId gasCalJob = JOB_INVALID;
+
+// Jobs the scheduler had no slot for, retried from loop()
+struct PendingJob {
+  const char* name;
+  unsigned long due;            // millis()
+  unsigned long period;         // 0 = one-shot
+  JobFunction fn;
+  void* context;
+  JobId* id;                    // updated once scheduled, may be null
+};
+PendingJob pendingJobs[SCHED_RETRY_MAX];
+uint8_t pendingJobCount = 0;
+int flashSteps = 0;
+const char* doorReason[BAY_MAX];
+TraceId doorTrace[BAY_MAX];
 
 // Function Prototypes
-void connectWiFi();
+void setupBootStages();
+bool bootStartWiFi();
+bool bootStartDashboard();
+bool bootWaitWiFi();
+bool bootStartNotifier();
+bool bootRunBenchmarks();
 void connectMQTT();
 void mqttCallback(char* topic, byte* payload, unsigned int length);
+void handleDoorCommand(const String& command, unsigned long receivedAt);
+void handleBenchCommand(const String& command);
+void benchJob(void* context);
+void handleAlarmCommand(const String& command);
+void handleVehicleHint(const String& payload);
+void handleGasCalibration();
+void gasCalibrationJob(void* context);
+void requestDoor(uint8_t bay, DoorState state, const char* reason, TraceId trace = TRACE_NONE);
+void trackApproach();
+void handleDashboardCommand(DashboardTarget target, const String& command);
 void checkVehicleDetection();
-void checkFireDetection();
-void checkIntrusionDetection();
-void handleDoorControl();
+void evaluateAlarmRules();
+void alarmRuleChanged(const AlarmRule& rule, bool active);
+void raiseFireAlarm();
+void raiseIntrusionAlarm();
+void setupJobs();
+JobId scheduleJob(const char* name, unsigned long delay, unsigned long period,
+                  JobFunction fn, void* context = nullptr, JobId* id = nullptr);
+void retryPendingJobs();
+void mqttJob(void* context);
+void linkJob(void* context);
+void bayJob(void* context);
+void sensorJob(void* context);
+void thingSpeakJob(void* context);
+void doorJob(void* context);
+void blinkJob(void* context);
+void statsJob(void* context);
+void traceJob(void* context);
+void bootJob(void* context);
+void vehicleAlertDone(void* context);
+void extinguisherDone(void* context);
+void startAlertFlash(int cycles, unsigned long halfPeriod);
+void alertFlashStep(void* context);
 void publishSensorData(const SensorData& data);
+void publishBayStatus(const char* topic, const char* status, uint8_t bay);
+void publishApproach(const Event& event);
+void setupEventSinks();
+void handleHistoryQuery(const String& payload);
+void mqttEventSink(const Event& event);
+void pushEventSink(const Event& event);
+void collectPushResults();
+void cloudEventSink(const Event& event);
+void dashboardEventSink(const Event& event);
 
 void setup() {
   Serial.begin(9600);
-  delay(1000);
 
   printWelcomeBanner();
 
-  // Initialize hardware
-  Serial.println("⚙️ Initializing hardware...");
+  // Everything after this goes through the async logger
+  logger.begin();
+
+  // Safety-critical hardware first: nothing here waits on the network
+  LOG_INFO("⚙️ Initializing hardware...");
   initializeGPIO();
 
-  servoDoor.attach(SERVO_DOOR_PIN);
+  bays.begin(BAY_TABLE, BAY_COUNT);
+  approach.begin(bays.count());
+
   servoExtinguisher.attach(SERVO_EXTINGUISHER_PIN);
-  servoDoor.write(0);
   servoExtinguisher.write(0);
-  Serial.println("  ✓Servos initialized");
+  LOG_INFO("  ✓Servos initialized");
 
   dht.setup(DHT_PIN, DHTesp::DHT22);
-  Serial.println("  ✓DHT22 initialized");
+  LOG_INFO("  ✓DHT22 initialized");
+
+  gasCalibration.begin();
 
-  // Connect WiFi
-  connectWiFi();
+  alarmRules.begin(ALARM_RULES, ALARM_RULE_COUNT, alarmRuleChanged);
+  LOG_INFO("  ✓%u alarm rules loaded", ALARM_RULE_COUNT);
 
-  // Initialize MQTT
+  // Client configuration only - mqttJob connects once WiFi is up
   mqttClient.setServer(MQTT_SERVER, MQTT_PORT);
   mqttClient.setCallback(mqttCallback);
-  Serial.println("  ✓MQTT configured");
+  mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
 
-  // Initialize Pushsafer
-  pushNotifier.begin();
-  if (pushNotifier.isReady()) {
-    pushNotifier.sendSystemOnline();
-  }
+  sensorPublisher.begin(REPORT_BY_EXCEPTION, PUBLISH_MAX_SILENCE, PUBLISH_RETAINED);
+  sensorPublisher.addSensorChannels(TOPIC_TEMPERATURE, TOPIC_HUMIDITY, TOPIC_SMOKE,
+                                    TOPIC_DISTANCE_OUT, TOPIC_DISTANCE_IN, TOPIC_PIR);
+  LOG_INFO("  ✓MQTT configured");
+
+  // Initialize ThingSpeak (one or more channels, see CLOUD_CHANNELS)
+  cloudLogger.begin(CLOUD_CHANNELS, CLOUD_CHANNEL_COUNT, CLOUD_FIELDS, CLOUD_FIELD_COUNT);
 
-  // Initialize ThingSpeak
-  cloudLogger.begin(THINGSPEAK_API_KEY);
+  // Route detector events to MQTT / Pushsafer / ThingSpeak
+  setupEventSinks();
 
-  Serial.println("\n========================================");
-  Serial.println("SYSTEM READY!");
-  Serial.println("========================================\n");
+#if FLEET_SIM_ENABLED
+  fleetSim.begin();
+#endif
 
-  delay(1000);
+  // Periodic duties, then WiFi / dashboard / Pushsafer in the background
+  setupJobs();
+  setupBootStages();
+
+  bootSequence.mark(BOOT_SAFETY_READY);
+  LOG_INFO("SYSTEM READY! (connectivity starting in background)");
 }
 
 void loop() {
-  unsigned long now = millis();
+  if (mqttClient.connected()) {
+    mqttClient.loop();
+  }
 
-  // Handle alarm blinking
-  handleAlarm();
+  // Fan out queued events to the sinks
+  eventBus.dispatch();
+  collectPushResults();
 
-  // MQTT connection
-  if (!mqttClient.connected()) {
-    if (now - lastMqttAttempt > MQTT_RETRY_INTERVAL) {
-      lastMqttAttempt = now;
-      connectMQTT();
+  // Apply dashboard commands
+  dashboard.loop();
+
+#if FLEET_SIM_ENABLED
+  fleetSim.loop();
+#endif
+
+  // Run due jobs, then sleep until the next one (at most SCHED_IDLE_MAX
+  // so MQTT, the event bus and the dashboard stay responsive)
+  scheduler.run();
+  retryPendingJobs();
+  delay(scheduler.nextWakeup());
+}
+
+// ============================================
+// SCHEDULED JOBS
+// ============================================
+void setupJobs() {
+  scheduleJob("mqtt", 0, MQTT_RETRY_INTERVAL, mqttJob);
+  scheduleJob("link", 0, WIFI_LINK_CHECK_INTERVAL, linkJob);
+  scheduleJob("bays", 0, BAY_PING_GAP, bayJob);
+  scheduleJob("sensors", 0, SENSOR_READ_INTERVAL, sensorJob);
+  scheduleJob("thingspeak", 0, THINGSPEAK_TICK, thingSpeakJob);
+  scheduleJob("doors", 0, DOOR_STEP_INTERVAL, doorJob);
+  scheduleJob("blink", 0, ALARM_BLINK_INTERVAL, blinkJob);
+  scheduleJob("stats", 0, EVENT_STATS_INTERVAL, statsJob);
+  scheduleJob("traces", 0, 1000, traceJob);
+  scheduleJob("boot", 0, BOOT_STAGE_INTERVAL, bootJob, nullptr, &bootJobId);
+
+  // First sample on the first loop() pass, not one period later
+  scheduleJob("sample0", 0, 0, sensorJob);
+
+  LOG_INFO("  ✓Scheduler jobs registered");
+}
+
+// scheduler.every() when period > 0 (first run after one period, delay
+// unused), else after(). A full job pool must not silently drop a job:
+// it is logged and retried from loop() until a slot frees up. `id`, if given, receives the JobId once scheduled; a
+// new request for the same `id` replaces one still waiting.
+JobId scheduleJob(const char* name, unsigned long delay, unsigned long period,
+                  JobFunction fn, void* context, JobId* id) {
+  JobId job = (period > 0) ? scheduler.every(name, period, fn, context)
+                           : scheduler.after(name, delay, fn, context);
+  if (id != nullptr) *id = job;
+  if (job != JOB_INVALID) return job;
+
+  uint8_t i = 0;
+  while (i < pendingJobCount && (id == nullptr || pendingJobs[i].id != id)) i++;
+  if (i == pendingJobCount) {
+    if (pendingJobCount >= SCHED_RETRY_MAX) {
+      LOG_ERROR("[Scheduler] ❌ No job slot for %s, retry queue full - dropped", name);
+      return JOB_INVALID;
     }
-  } else {
-    mqttClient.loop();
+    pendingJobCount++;
   }
 
-  // Check vehicle detection
-  if (now - lastDistanceCheck >= DISTANCE_CHECK_INTERVAL) {
-    lastDistanceCheck = now;
+  pendingJobs[i] = { name, millis() + delay, period, fn, context, id };
+  LOG_ERROR("[Scheduler] ❌ No job slot for %s, will retry", name);
+  return JOB_INVALID;
+}
+
+void retryPendingJobs() {
+  uint8_t i = 0;
+  while (i < pendingJobCount) {
+    PendingJob& pending = pendingJobs[i];
+    long remaining = (long)(pending.due - millis());
+
+    JobId job = (pending.period > 0)
+      ? scheduler.every(pending.name, pending.period, pending.fn, pending.context)
+      : scheduler.after(pending.name, remaining > 0 ? remaining : 0, pending.fn, pending.context);
+    if (job == JOB_INVALID) return;   // still full, try again next pass
+
+    LOG_WARN("[Scheduler] %s scheduled after retry", pending.name);
+    if (pending.id != nullptr) *pending.id = job;
+    pendingJobs[i] = pendingJobs[--pendingJobCount];
+  }
+}
+
+// MQTT reconnect
+void mqttJob(void* context) {
+  if (!mqttClient.connected()) {
+    connectMQTT();
+  }
+}
+
+// WiFi back after a drop: the saved Pushsafer TLS session may have
+// expired meanwhile, refresh it before an alert needs it. No-op until
+// bootStartNotifier() has started the send task.
+void linkJob(void* context) {
+  static bool wasUp = false;
+
+  bool up = WiFi.status() == WL_CONNECTED;
+  if (up && !wasUp && pushNotifier.prewarm()) {
+    LOG_INFO("[Pushsafer] WiFi up, TLS warm-up queued");
+  }
+  wasUp = up;
+}
+
+// Ping one ultrasonic sensor per run (every BAY_PING_GAP); evaluate all
+// bays after each sweep. The next sweep waits until BAY_SWEEP_INTERVAL
+// after this one started, so pulseIn() holds loop() for a bounded share.
+void bayJob(void* context) {
+  static unsigned long sweepStart = 0;
+  static bool sweeping = false;
+
+  unsigned long now = millis();
+  if (!sweeping) {
+    if (now - sweepStart < BAY_SWEEP_INTERVAL) return;
+    sweepStart = now;
+    sweeping = true;
+  }
+
+  if (bays.acquire()) {
+    trackApproach();
     checkVehicleDetection();
+    sweeping = false;
   }
+}
 
-  // Read sensors periodically
-  if (now - lastSensorRead >= SENSOR_READ_INTERVAL) {
-    lastSensorRead = now;
+// Read sensors
+void sensorJob(void* context) {
+  currentSensorData = readEnvironment(dht);
+  currentSensorData.distanceOutside = bays.distanceOutside(0);
+  currentSensorData.distanceInside = bays.distanceInside(0);
+  printSensorData(currentSensorData);
+  history.append(currentSensorData);
+  dashboard.pushSensorData(currentSensorData);
 
-    currentSensorData = readAllSensors(dht);
-    printSensorData(currentSensorData);
+  publishSensorData(currentSensorData);
 
-    publishSensorData(currentSensorData);
+  evaluateAlarmRules();
+  bootSequence.mark(BOOT_FIRST_SAMPLE);
+}
 
-    checkFireDetection();
-    checkIntrusionDetection();
+// Upload to ThingSpeak: refresh the metrics, then whichever channel is due
+void thingSpeakJob(void* context) {
+  uint8_t vehicles = 0;
+  uint8_t doorsOpen = 0;
+  for (uint8_t bay = 0; bay < bays.count(); bay++) {
+    if (bays.vehiclePresent(bay)) vehicles++;
+    if (bays.getDoorState(bay) != DOOR_CLOSED) doorsOpen++;
   }
 
-  // Upload to ThingSpeak
-  if (now - lastThingSpeakUpload >= THINGSPEAK_INTERVAL) {
-    lastThingSpeakUpload = now;
-    cloudLogger.uploadSensorData(currentSensorData);
+  cloudLogger.updateSensorData(currentSensorData);
+  cloudLogger.setMetric(CLOUD_VEHICLES, vehicles);
+  cloudLogger.setMetric(CLOUD_DOORS_OPEN, doorsOpen);
+  cloudLogger.setMetric(CLOUD_ALARM, alarmState);
+
+  if (cloudLogger.uploadDue()) {
+    bootSequence.mark(BOOT_THINGSPEAK_UPLOAD);
   }
+}
 
-  // Handle door state
-  handleDoorControl();
+void statsJob(void* context) {
+  eventBus.printStats();
+  history.printStats();
+  sensorPublisher.printStats();
+  pushNotifier.printTlsStats();
+  scheduler.printStats();
+  approach.printStats();
+  logger.printStats();
+  tracer.printStats();
+  alarmRules.printStats();
+  cloudLogger.printStats();
+}
+
+void traceJob(void* context) {
+  tracer.expire();
+}
+
+// Deferred boot stages; the timeline is published once MQTT is up
+void bootJob(void* context) {
+  if (bootSequence.step() && bootSequence.publish()) {
+    scheduler.cancel(bootJobId);
+  }
+}
 
-  delay(10);
+void setupBootStages() {
+  bootSequence.addStage("wifi", bootStartWiFi);
+  bootSequence.addStage("dashboard", bootStartDashboard);
+  bootSequence.addStage("link", bootWaitWiFi);
+  bootSequence.addStage("notifier", bootStartNotifier);
+  bootSequence.addStage("bench", bootRunBenchmarks);
 }
 
-// WiFi Connection
-void connectWiFi() {
-  Serial.print("Connecting to WiFi");
+// WiFi Connection (non-blocking, bootWaitWiFi polls for the link)
+bool bootStartWiFi() {
+  LOG_INFO("Connecting to WiFi...");
+  WiFi.mode(WIFI_STA);
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  return true;
+}
+
+// Local dashboard (works without the uplink)
+bool bootStartDashboard() {
+  dashboard.begin(handleDashboardCommand, bays.count());
+  return true;
+}
+
+bool bootWaitWiFi() {
+  static bool warned = false;
 
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
+  if (WiFi.status() != WL_CONNECTED) {
+    if (!warned && millis() > BOOT_WIFI_WARN) {
+      LOG_WARN("WiFi still down after %lu ms, sensing continues offline", millis());
+      warned = true;
+    }
+    return false;
   }
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println(" connected!");
-    Serial.print("  IP: ");
-    Serial.println(WiFi.localIP());
-  } else {
-    Serial.println(" FAILED!");
+  LOG_INFO("WiFi connected, IP: %s", logCopy(WiFi.localIP().toString()));
+  bootSequence.mark(BOOT_WIFI_CONNECTED);
+  return true;
+}
+
+// Initialize Pushsafer (needs WiFi). The TLS warm-up goes first so the
+// "online" notice, or an alert, resumes its session. The notice is low
+// priority: it is only queued for the Pushsafer task, and an alert
+// raised meanwhile is sent first.
+bool bootStartNotifier() {
+  pushNotifier.begin();
+  if (!pushNotifier.isReady()) return true;
+  pushNotifier.startTask();
+  pushNotifier.prewarm();
+  bootSequence.mark(BOOT_NOTIFIER_READY);
+
+  if (!pushNotifier.post(NOTIFY_SYSTEM_ONLINE)) {
+    LOG_WARN("[Boot] Online notice not sent");
   }
+  return true;
+}
+
+bool bootRunBenchmarks() {
+  // The render cases write postBuffer: not the one the Pushsafer task sends from
+  microBench.addFirmwareCases(psNotifier, cloudLogger);
+  microBench.run(BENCH_BOOT_MODE);
+  return true;
 }
 
 // MQTT Connection
 void connectMQTT() {
   if (WiFi.status() != WL_CONNECTED) return;
 
-  Serial.print("Connecting to MQTT...");
   String clientId = "ESP32-Garage-" + String(random(0xffff), HEX);
 
   if (mqttClient.connect(clientId.c_str())) {
-    Serial.println(" connected!");
+    LOG_INFO("MQTT connected");
+    bootSequence.mark(BOOT_MQTT_CONNECTED);
 
     mqttClient.subscribe(TOPIC_DOOR_CMD);
     mqttClient.subscribe(TOPIC_ALARM_CMD);
+    mqttClient.subscribe(TOPIC_HISTORY_QUERY);
+    mqttClient.subscribe(TOPIC_VEHICLE_HINT);
+    mqttClient.subscribe(TOPIC_GAS_CALIBRATE);
+    mqttClient.subscribe(TOPIC_DIAG_BENCH_CMD);
+
+    LOG_INFO("  Subscribed to control topics");
 
-    Serial.println("  Subscribed to control topics");
+    // Values may have moved while offline - report everything again
+    sensorPublisher.invalidate();
 
     mqttClient.publish(TOPIC_DOOR_STATUS, "CLOSED");
   } else {
-    Serial.print(" failed, rc=");
-    Serial.println(mqttClient.state());
+    LOG_WARN("MQTT connect failed, rc=%d", mqttClient.state());
   }
 }
 
 // MQTT Callback
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-  String message = "";
-  for (unsigned int i = 0; i < length; i++) {
-    message += (char)payload[i];
-  }
+  unsigned long receivedAt = micros();
+  String message = CommandParser::payloadToString(payload, length);
 
-  Serial.print("MQTT [");
-  Serial.print(topic);
-  Serial.print("]: ");
-  Serial.println(message);
+  LOG_INFO("MQTT %s", logCopy("[" + String(topic) + "]: " + message));
 
   // Door control
   if (String(topic) == TOPIC_DOOR_CMD) {
-    if (message == "OPEN") {
-      doorState = DOOR_OPENING;
-      Serial.println("-> Door command: OPEN");
-    } else if (message == "CLOSE") {
-      doorState = DOOR_CLOSING;
-      Serial.println("-> Door command: CLOSE");
-    }
+    handleDoorCommand(message, receivedAt);
   }
 
   // Alarm control
   if (String(topic) == TOPIC_ALARM_CMD) {
-    if (message == "ON") {
-      alarmState = ALARM_ON;
-      mqttClient.publish(TOPIC_ALARM_STATUS, "ON");
-      pushNotifier.sendAlarmActivated("Manual activation");
-      Serial.println("-> Alarm: ON");
-    } else if (message == "OFF") {
-      digitalWrite(LED_INSIDE_PIN, false);
-      digitalWrite(LED_OUTSIDE_PIN, false);
-      noTone(BUZZER_PIN);
-      mqttClient.publish(TOPIC_ALARM_STATUS, "OFF");
-      pushNotifier.sendAlarmDeactivated("Manual");
-      Serial.println("-> Alarm: OFF");
-      alarmState = ALARM_OFF;
+    handleAlarmCommand(message);
+  }
+
+  // History query
+  if (String(topic) == TOPIC_HISTORY_QUERY) {
+    handleHistoryQuery(message);
+  }
+
+  // Arrival hint (authorises a predictive opening)
+  if (String(topic) == TOPIC_VEHICLE_HINT) {
+    handleVehicleHint(message);
+  }
+
+  // Gas sensor baseline
+  if (String(topic) == TOPIC_GAS_CALIBRATE) {
+    handleGasCalibration();
+  }
+
+  // Microbenchmarks
+  if (String(topic) == TOPIC_DIAG_BENCH_CMD) {
+    handleBenchCommand(message);
+  }
+}
+
+// Door Command (MQTT + dashboard), see CommandParser::parseDoor()
+void handleDoorCommand(const String& command, unsigned long receivedAt) {
+  DoorCommand cmd;
+  if (!CommandParser::parseDoor(command, bays.count(), cmd)) return;
+
+  bool open = (cmd.action == "OPEN");
+  TraceId trace = tracer.begin(open ? TRACE_DOOR_OPEN : TRACE_DOOR_CLOSE,
+                               cmd.id.c_str(), cmd.bay, receivedAt);
+  requestDoor(cmd.bay, open ? DOOR_OPENING : DOOR_CLOSING, "User command", trace);
+  LOG_INFO("-> Door command: %s, bay %d %s", open ? "OPEN" : "CLOSE", cmd.bay, logCopy(cmd.id));
+}
+
+// A newer request on the same bay supersedes any trace still in flight
+void requestDoor(uint8_t bay, DoorState state, const char* reason, TraceId trace) {
+  if (doorTrace[bay] != trace) tracer.abandon(doorTrace[bay]);
+  doorTrace[bay] = trace;
+  tracer.mark(trace, TRACE_ACCEPTED);
+
+  doorReason[bay] = reason;
+  bays.setDoorState(bay, state);
+}
+
+// Vehicle Hint: "" or "<bay>"
+void handleVehicleHint(const String& payload) {
+  int bay = payload.length() ? payload.toInt() : 0;
+  if (bay < 0 || bay >= bays.count()) return;
+
+  approach.hint(bay, millis());
+  LOG_INFO("-> Arrival hint, bay %d", bay);
+}
+
+// Benchmark Command: runs from the scheduler, outside the MQTT callback
+void handleBenchCommand(const String& command) {
+  int mode = MicroBench::parseMode(command);
+  if (mode == BENCH_MODE_OFF) return;
+
+  LOG_INFO("-> Benchmark %s", logCopy(command));
+  scheduleJob("bench", 0, 0, benchJob, (void*)(uintptr_t)mode);
+}
+
+void benchJob(void* context) {
+  microBench.run((uintptr_t)context);
+}
+
+// Gas Calibration: refused while a fire alarm is active. One ADC sample
+// per job run, so the MQTT callback returns at once.
+void handleGasCalibration() {
+  if (alarmState == ALARM_FIRE) {
+    LOG_WARN("⚠️ Gas calibration refused during fire alarm");
+    return;
+  }
+  if (!gasCalibration.startCalibration()) {
+    LOG_WARN("⚠️ Gas calibration already running");
+    return;
+  }
+
+  LOG_INFO("-> Gas calibration (clean air)...");
+  scheduleJob("gas-cal", 0, GAS_CALIBRATION_INTERVAL, gasCalibrationJob, nullptr, &gasCalJob);
+}
+
+void gasCalibrationJob(void* context) {
+  GasCalStatus status;
+  if (alarmState == ALARM_FIRE) {
+    // Smoke would skew R0
+    gasCalibration.cancelCalibration();
+    LOG_WARN("⚠️ Gas calibration aborted by fire alarm");
+    status = GAS_CAL_FAILED;
+  } else {
+    status = gasCalibration.calibrationStep(GAS_SENSOR_PIN);
+    if (status == GAS_CAL_RUNNING) return;
+  }
+
+  scheduler.cancel(gasCalJob);
+  gasCalJob = JOB_INVALID;
+
+  char payload[32];
+  if (status == GAS_CAL_DONE) {
+    snprintf(payload, sizeof(payload), "OK,%lu,%d",
+             (unsigned long)gasCalibration.getR0(), gasCalibration.getCalibrationAdc());
+  } else {
+    strlcpy(payload, "FAILED", sizeof(payload));
+  }
+  mqttClient.publish(TOPIC_GAS_CALIBRATION, payload);
+}
+
+// Alarm Command (MQTT + dashboard)
+void handleAlarmCommand(const String& command) {
+  AlarmCommand cmd = CommandParser::parseAlarm(command);
+  if (cmd == ALARM_CMD_ON) {
+    alarmState = ALARM_ON;
+    eventBus.publish(EVT_ALARM_ON, 0, 0, 0, "Manual activation");
+    LOG_INFO("-> Alarm: ON");
+  } else if (cmd == ALARM_CMD_OFF) {
+    digitalWrite(LED_INSIDE_PIN, false);
+    digitalWrite(LED_OUTSIDE_PIN, false);
+    noTone(BUZZER_PIN);
+    eventBus.publish(EVT_ALARM_OFF, 0, 0, 0, "Manual");
+    LOG_INFO("-> Alarm: OFF");
+    alarmState = ALARM_OFF;
+  }
+}
+
+// Dashboard Command
+void handleDashboardCommand(DashboardTarget target, const String& command) {
+  if (target == DASH_DOOR) {
+    handleDoorCommand(command, micros());
+  } else if (target == DASH_ALARM) {
+    handleAlarmCommand(command);
+  }
+}
+
+// History Query Reply
+void handleHistoryQuery(const String& payload) {
+  HistoryQuery query;
+  if (!HistoryStore::parseQuery(payload, query)) {
+    mqttClient.publish(TOPIC_HISTORY_REPLY, "ERR,bad query");
+    return;
+  }
+
+  char reply[MQTT_BUFFER_SIZE - 64];  // leave room for MQTT header + topic
+  int parts = history.replyParts(query);
+
+  for (int part = 0; part < parts; part++) {
+    size_t len = history.encodeReply(query, part, reply, sizeof(reply));
+    if (len == 0) {
+      mqttClient.publish(TOPIC_HISTORY_REPLY, "ERR,reply too large");
+      return;
     }
+    mqttClient.publish(TOPIC_HISTORY_REPLY, (const uint8_t*)reply, len);
   }
 }
 
 // Alarm Manual Blinking
-unsigned long lastBlink = 0;
 bool blinkState = false;
 
-void handleAlarm() {
+void blinkJob(void* context) {
   if (alarmState != ALARM_ON) return;
 
-  unsigned long now = millis();
+  blinkState = !blinkState;
+
+  digitalWrite(LED_INSIDE_PIN, blinkState);
+  digitalWrite(LED_OUTSIDE_PIN, blinkState);
 
-  if (now - lastBlink >= 200) {
-    lastBlink = now;
-    blinkState = !blinkState;
+  if (blinkState)
+    tone(BUZZER_PIN, 2000);
+  else
+    noTone(BUZZER_PIN);
+}
+
+// Fire/intrusion LED flash: `cycles` on/off pairs, one step per job run
+void startAlertFlash(int cycles, unsigned long halfPeriod) {
+  scheduler.cancel(flashJob);
+  flashSteps = cycles * 2;
+  scheduleJob("flash", 0, halfPeriod, alertFlashStep, nullptr, &flashJob);
+  alertFlashStep(nullptr);
+}
 
-    digitalWrite(LED_INSIDE_PIN, blinkState);
-    digitalWrite(LED_OUTSIDE_PIN, blinkState);
+void alertFlashStep(void* context) {
+  bool on = (flashSteps % 2 == 0) && flashSteps > 0;
 
-    if (blinkState)
-      tone(BUZZER_PIN, 2000);
-    else
-      noTone(BUZZER_PIN);
+  digitalWrite(LED_INSIDE_PIN, on);
+  digitalWrite(LED_OUTSIDE_PIN, on);
+  if (on) tone(BUZZER_PIN, 2000, 200);
+
+  if (flashSteps > 0) flashSteps--;
+  if (flashSteps == 0) {
+    scheduler.cancel(flashJob);
+    flashJob = JOB_INVALID;
   }
 }
 
-// Vehicle Detection
-void checkVehicleDetection() {
-  float distance = readUltrasonic(ECHO_OUTSIDE_PIN, TRIG_OUTSIDE_PIN);
-
-  if (distance < VEHICLE_DETECT_DISTANCE) {
-    if (!vehicleDetectedOutside) {
-      vehicleDetectedOutside = true;
-      vehicleDetectedTime = millis();
-
-      Serial.println("\n========================================");
-      Serial.print("🚗 VEHICLE DETECTED: ");
-      Serial.print(distance, 1);
-      Serial.println(" cm");
-      Serial.println("========================================");
-
-      pushNotifier.sendVehicleDetected(distance);
-      cloudLogger.uploadEvent("VEHICLE_DETECTED", String(distance, 1));
-      mqttClient.publish(TOPIC_VEHICLE_DETECTED, "true");
+// Approach Tracking (all bays, once per ultrasonic sweep)
+// State changes are coalesced: at most one EVT_VEHICLE_APPROACH per bay
+// every APPROACH_EVENT_MIN_GAP, carrying the latest state.
+void trackApproach() {
+  static unsigned long lastEventAt[BAY_MAX];
+  static ApproachState lastEventState[BAY_MAX];
+  static uint8_t pendingMask = 0;
+  unsigned long now = millis();
+
+  for (uint8_t bay = 0; bay < bays.count(); bay++) {
+    uint8_t bit = 1 << bay;
+
+    if (approach.addSample(bay, bays.distanceOutside(bay), now)) {
+      pendingMask |= bit;
     }
 
-    // Check timeout
-    if (millis() - vehicleDetectedTime > WAIT_RESPONSE_TIME) {
-      if (doorState == DOOR_CLOSED) {
-        Serial.println("\n⚠️ NO RESPONSE - ACTIVATING ALERT");
-        digitalWrite(LED_OUTSIDE_PIN, true);
-        tone(BUZZER_PIN, 1000, 2000);
-
-        delay(5000);
-        digitalWrite(LED_OUTSIDE_PIN, false);
-        vehicleDetectedOutside = false;
-        mqttClient.publish(TOPIC_VEHICLE_DETECTED, "false");
+    if ((pendingMask & bit) && now - lastEventAt[bay] >= APPROACH_EVENT_MIN_GAP) {
+      pendingMask &= ~bit;
+
+      // Flipped back within the gap: nothing new to report
+      ApproachState current = approach.getState(bay);
+      if (current != lastEventState[bay]) {
+        long eta = approach.getEtaMs(bay);
+        eventBus.publish(EVT_VEHICLE_APPROACH, approach.getVelocity(bay),
+                         eta < 0 ? -1 : eta / 1000.0, current, "", bay);
+        lastEventAt[bay] = now;
+        lastEventState[bay] = current;
       }
     }
-  } else {
-    if (vehicleDetectedOutside) {
-      vehicleDetectedOutside = false;
-      mqttClient.publish(TOPIC_VEHICLE_DETECTED, "false");
+
+    if (bays.getDoorState(bay) == DOOR_CLOSED && approach.shouldPreOpen(bay, now)) {
+      LOG_INFO("🚗 Predictive opening, ETA %ld ms, bay %u", approach.getEtaMs(bay), bay);
+
+      approach.onPreOpen(bay, now);
+      requestDoor(bay, DOOR_OPENING, "Predictive");
+    }
+
+    // Nobody arrived: close again and count a false pre-open
+    if (approach.preOpenExpired(bay, now) &&
+        bays.getDoorState(bay) == DOOR_OPEN && !bays.vehiclePresent(bay)) {
+      requestDoor(bay, DOOR_CLOSING, "Pre-open expired");
     }
   }
 }
 
-// Fire Detection
-void checkFireDetection() {
-  if (currentSensorData.temperatureDHT > TEMP_CRITICAL_THRESHOLD ||
-      currentSensorData.smokeLevel > SMOKE_CRITICAL_THRESHOLD) {
+// Vehicle Detection (all bays)
+void checkVehicleDetection() {
+  BayChanges changes = bays.detect(millis());
+  if (!(changes.arrived | changes.left | changes.timedOut)) return;
+
+  for (uint8_t bay = 0; bay < bays.count(); bay++) {
+    uint8_t bit = 1 << bay;
 
-    Serial.println("\n========================================");
-    Serial.println("🔥 FIRE DETECTED!");
-    Serial.println("========================================");
+    if (changes.arrived & bit) {
+      float distance = bays.distanceOutside(bay);
 
-    alarmState = ALARM_FIRE;
+      LOG_INFO("🚗 VEHICLE DETECTED: %.1f cm, bay %u", distance, bay);
 
-    // LED alert
-    for (int i = 0; i < 20; i++) {
-      digitalWrite(LED_INSIDE_PIN, true);
-      digitalWrite(LED_OUTSIDE_PIN, true);
-      tone(BUZZER_PIN, 2000, 200);
-      delay(100);
-      digitalWrite(LED_INSIDE_PIN, false);
-      digitalWrite(LED_OUTSIDE_PIN, false);
-      delay(100);
+      eventBus.publish(EVT_VEHICLE_DETECTED, distance, 0, 0, "", bay);
+      approach.onArrival(bay, millis(), bays.getDoorState(bay) == DOOR_OPEN);
     }
 
-    // Send emergency notification
-    mqttClient.publish(TOPIC_ALARM_STATUS, "FIRE_DETECTED");
-
-
-    pushNotifier.sendFireAlert(
-      currentSensorData.temperatureDHT,
-      currentSensorData.smokeLevel,
-      currentSensorData.humidity
-    );
-
-    // Activate fire extinguisher
-    Serial.println("ACTIVATING FIRE EXTINGUISHER SERVO...");
-    servoExtinguisher.write(90);
-    delay(5000);
-    servoExtinguisher.write(0);
-    Serial.println("Fire extinguisher servo deactivated");
-    
-    // Send extinguisher notification
-    pushNotifier.send("Fire Extinguisher Activated", 
-                      "Servo chữa cháy đã được kích hoạt tự động", 
-                      PRIORITY_EMERGENCY);
-
-    cloudLogger.uploadEvent("FIRE_ALERT", "CRITICAL");
-  
- 
-  }
-  else if (currentSensorData.temperatureDHT > TEMP_WARNING_THRESHOLD ||
-           currentSensorData.smokeLevel > SMOKE_WARNING_THRESHOLD) {
-
-    // Warning level
-    if (currentSensorData.temperatureDHT > TEMP_WARNING_THRESHOLD) {
-      pushNotifier.sendHighTemperature(currentSensorData.temperatureDHT);
+    if (changes.left & bit) {
+      eventBus.publish(EVT_VEHICLE_LEFT, 0, 0, 0, "", bay);
+      approach.onDeparture(bay);
     }
 
-    if (currentSensorData.smokeLevel > SMOKE_WARNING_THRESHOLD) {
-      pushNotifier.sendHighSmoke(currentSensorData.smokeLevel);
+    if (changes.timedOut & bit) {
+      LOG_WARN("⚠️ NO RESPONSE - ACTIVATING ALERT, bay %u", bay);
+      digitalWrite(bays.outsideLed(bay), true);
+      tone(BUZZER_PIN, 1000, 2000);
+
+      scheduleJob("vehicle-alert", VEHICLE_ALERT_TIME, 0, vehicleAlertDone,
+                  (void*)(uintptr_t)bay);
     }
   }
-  else if (alarmState == ALARM_FIRE &&
-           currentSensorData.temperatureDHT < TEMP_WARNING_THRESHOLD &&
-           currentSensorData.smokeLevel < SMOKE_WARNING_THRESHOLD) {
-    alarmState = ALARM_OFF;
-    mqttClient.publish(TOPIC_ALARM_STATUS, "OFF");
+}
+
+void vehicleAlertDone(void* context) {
+  uint8_t bay = (uintptr_t)context;
+
+  digitalWrite(bays.outsideLed(bay), false);
+  eventBus.publish(EVT_VEHICLE_TIMEOUT, 0, 0, 0, "", bay);
+  bays.rearm(bay);
+}
+
+// Alarm Rules (one evaluation per sensor sample, see ALARM_RULES)
+void evaluateAlarmRules() {
+  float inputs[RULE_IN_COUNT];
+  inputs[RULE_IN_TEMPERATURE] = currentSensorData.temperatureDHT;
+  inputs[RULE_IN_HUMIDITY] = currentSensorData.humidity;
+  inputs[RULE_IN_SMOKE] = currentSensorData.smokeLevel;
+  inputs[RULE_IN_PIR] = currentSensorData.pirMotion;
+  inputs[RULE_IN_DOORS_CLOSED] = bays.allDoorsClosed();
+
+  alarmRules.evaluate(inputs, millis());
+}
+
+void alarmRuleChanged(const AlarmRule& rule, bool active) {
+  LOG_INFO("[Rules] %s %s", rule.name, active ? "fired" : "cleared");
+
+  switch (rule.action) {
+    case RULE_ACTION_FIRE:
+      if (active) {
+        raiseFireAlarm();
+      } else if (alarmState == ALARM_FIRE) {
+        alarmState = ALARM_OFF;
+        eventBus.publish(EVT_FIRE_CLEARED);
+      }
+      break;
+
+    // Warnings are redundant while the fire alarm is up
+    case RULE_ACTION_HIGH_TEMPERATURE:
+      if (active && alarmState != ALARM_FIRE) {
+        eventBus.publish(EVT_HIGH_TEMPERATURE, currentSensorData.temperatureDHT);
+      }
+      break;
+    case RULE_ACTION_HIGH_SMOKE:
+      if (active && alarmState != ALARM_FIRE) {
+        eventBus.publish(EVT_HIGH_SMOKE, 0, 0, currentSensorData.smokeLevel);
+      }
+      break;
+
+    case RULE_ACTION_INTRUSION:
+      if (active) {
+        raiseIntrusionAlarm();
+      } else if (alarmState == ALARM_INTRUSION) {
+        alarmState = ALARM_OFF;
+        eventBus.publish(EVT_INTRUSION_CLEARED);
+      }
+      break;
   }
 }
 
-// Intrusion Detection
-void checkIntrusionDetection() {
-  if (doorState == DOOR_CLOSED &&
-      currentSensorData.pirMotion) {
+// Fire Response
+void raiseFireAlarm() {
+  // Extinguisher sequence from the previous trigger still running
+  if (scheduler.isScheduled(extinguisherJob)) return;
+
+  TraceId trace = tracer.beginFire(micros());
+  LOG_ERROR("🔥 FIRE DETECTED! %s", logCopy(tracer.idOf(trace)));
+
+  alarmState = ALARM_FIRE;
+
+  // LED alert
+  startAlertFlash(20, 100);
+
+  // Send emergency notification
+  eventBus.publish(EVT_FIRE_ALERT,
+                   currentSensorData.temperatureDHT,
+                   currentSensorData.humidity,
+                   currentSensorData.smokeLevel, "", 0, trace);
+  tracer.mark(trace, TRACE_EVENT_QUEUED);
+
+  // Activate fire extinguisher
+  LOG_INFO("ACTIVATING FIRE EXTINGUISHER SERVO...");
+  servoExtinguisher.write(90);
+  tracer.mark(trace, TRACE_ACTUATION_START);
+  scheduleJob("extinguisher", EXTINGUISHER_HOLD_TIME, 0, extinguisherDone, nullptr, &extinguisherJob);
+}
+
+void extinguisherDone(void* context) {
+  servoExtinguisher.write(0);
+  LOG_INFO("Fire extinguisher servo deactivated");
+
+  // Send extinguisher notification
+  eventBus.publish(EVT_EXTINGUISHER_ACTIVATED);
+}
 
-    Serial.println("\n========================================");
-    Serial.println("🚨 INTRUSION DETECTED!");
-    Serial.println("========================================");
+// Intrusion Response
+void raiseIntrusionAlarm() {
+  LOG_ERROR("🚨 INTRUSION DETECTED!");
 
-    alarmState = ALARM_INTRUSION;
+  alarmState = ALARM_INTRUSION;
 
-    // Activate alarm
-    for (int i = 0; i < 10; i++) {
-      digitalWrite(LED_INSIDE_PIN, true);
-      digitalWrite(LED_OUTSIDE_PIN, true);
-      tone(BUZZER_PIN, 2000, 200);
-      delay(200);
-      digitalWrite(LED_INSIDE_PIN, false);
-      digitalWrite(LED_OUTSIDE_PIN, false);
-      delay(200);
+  // Activate alarm
+  startAlertFlash(10, 200);
+  eventBus.publish(EVT_INTRUSION);
+}
+
+// Door Control (all bays, one servo step per run)
+void doorJob(void* context) {
+  for (uint8_t bay = 0; bay < bays.count(); bay++) {
+    DoorState state = bays.getDoorState(bay);
+    if (state == DOOR_OPENING || state == DOOR_CLOSING) {
+      tracer.mark(doorTrace[bay], TRACE_ACTUATION_START);
+    }
+    if (!bays.stepDoor(bay)) continue;
+
+    TraceId trace = doorTrace[bay];
+    doorTrace[bay] = TRACE_NONE;
+    tracer.mark(trace, TRACE_ACTUATION_DONE);
+
+    if (bays.getDoorState(bay) == DOOR_OPEN) {
+      LOG_INFO("✓ Door opened %s", logCopy(tracer.idOf(trace)));
+      approach.onDoorOpened(bay, millis());
+      eventBus.publish(EVT_DOOR_OPENED, 0, 0, 0, doorReason[bay], bay, trace);
+    } else {
+      LOG_INFO("✓ Door closed %s", logCopy(tracer.idOf(trace)));
+      eventBus.publish(EVT_DOOR_CLOSED, 0, 0, 0, doorReason[bay], bay, trace);
     }
-    mqttClient.publish(TOPIC_ALARM_STATUS, "INTRUSION_DETECTED");
-    pushNotifier.sendIntrusionAlert(true, true);
-    cloudLogger.uploadEvent("INTRUSION", "CRITICAL");
+    tracer.mark(trace, TRACE_EVENT_QUEUED);
+  }
+}
+
+// Event Sinks
+void setupEventSinks() {
+  int mqttSink = eventBus.addSink("MQTT", mqttEventSink, EVENT_BATCH_MQTT);
+  int pushSink = eventBus.addSink("Pushsafer", pushEventSink, EVENT_BATCH_PUSH);
+  int cloudSink = eventBus.addSink("ThingSpeak", cloudEventSink, EVENT_BATCH_CLOUD);
+  int dashSink = eventBus.addSink("Dashboard", dashboardEventSink, EVENT_BATCH_MQTT);
 
+  for (int type = 0; type < EVT_TYPE_COUNT; type++) {
+    eventBus.subscribe(mqttSink, (EventType)type);
+    eventBus.subscribe(dashSink, (EventType)type);
   }
-  else if (alarmState == ALARM_INTRUSION &&
-           !currentSensorData.pirMotion) {
-    alarmState = ALARM_OFF;
-    mqttClient.publish(TOPIC_ALARM_STATUS, "OFF");
-  }
-}
-
-// Door Control
-void handleDoorControl() {
-  static DoorState lastState = DOOR_CLOSED;
-
-  if (doorState != lastState) {
-    switch (doorState) {
-      case DOOR_OPENING:
-        openDoor(servoDoor);
-        doorState = DOOR_OPEN;
-        mqttClient.publish(TOPIC_DOOR_STATUS, "OPENED");
-        cloudLogger.uploadEvent("DOOR", "OPENED");
-        pushNotifier.sendDoorOpened("User command");
-        break;
-
-      case DOOR_CLOSING:
-        closeDoor(servoDoor);
-        doorState = DOOR_CLOSED;
-        mqttClient.publish(TOPIC_DOOR_STATUS, "CLOSED");
-        cloudLogger.uploadEvent("DOOR", "CLOSED");
-        pushNotifier.sendDoorClosed("User command");
-        break;
-
-      default:
-        break;
+
+  eventBus.subscribe(pushSink, EVT_DOOR_OPENED);
+  eventBus.subscribe(pushSink, EVT_DOOR_CLOSED);
+  eventBus.subscribe(pushSink, EVT_VEHICLE_DETECTED);
+  eventBus.subscribe(pushSink, EVT_FIRE_ALERT);
+  eventBus.subscribe(pushSink, EVT_EXTINGUISHER_ACTIVATED);
+  eventBus.subscribe(pushSink, EVT_HIGH_TEMPERATURE);
+  eventBus.subscribe(pushSink, EVT_HIGH_SMOKE);
+  eventBus.subscribe(pushSink, EVT_INTRUSION);
+  eventBus.subscribe(pushSink, EVT_ALARM_ON);
+  eventBus.subscribe(pushSink, EVT_ALARM_OFF);
+
+  eventBus.subscribe(cloudSink, EVT_DOOR_OPENED);
+  eventBus.subscribe(cloudSink, EVT_DOOR_CLOSED);
+  eventBus.subscribe(cloudSink, EVT_VEHICLE_DETECTED);
+  eventBus.subscribe(cloudSink, EVT_FIRE_ALERT);
+  eventBus.subscribe(cloudSink, EVT_INTRUSION);
+
+  LOG_INFO("  ✓Event sinks registered");
+}
+
+void mqttEventSink(const Event& event) {
+  switch (event.type) {
+    case EVT_DOOR_OPENED:
+      publishBayStatus(TOPIC_DOOR_STATUS, "OPENED", event.bay);
+      tracer.finish(event.trace);
+      break;
+    case EVT_DOOR_CLOSED:
+      publishBayStatus(TOPIC_DOOR_STATUS, "CLOSED", event.bay);
+      tracer.finish(event.trace);
+      break;
+    case EVT_VEHICLE_DETECTED:
+      publishBayStatus(TOPIC_VEHICLE_DETECTED, "true", event.bay);
+      break;
+    case EVT_VEHICLE_LEFT:
+    case EVT_VEHICLE_TIMEOUT:
+      publishBayStatus(TOPIC_VEHICLE_DETECTED, "false", event.bay);
+      break;
+    case EVT_VEHICLE_APPROACH:
+      publishApproach(event);
+      break;
+    case EVT_FIRE_ALERT:
+      mqttClient.publish(TOPIC_ALARM_STATUS, "FIRE_DETECTED");
+      break;
+    case EVT_INTRUSION:
+      mqttClient.publish(TOPIC_ALARM_STATUS, "INTRUSION_DETECTED");
+      break;
+    case EVT_ALARM_ON:
+      mqttClient.publish(TOPIC_ALARM_STATUS, "ON");
+      break;
+    case EVT_FIRE_CLEARED:
+    case EVT_INTRUSION_CLEARED:
+    case EVT_ALARM_OFF:
+      mqttClient.publish(TOPIC_ALARM_STATUS, "OFF");
+      break;
+    default:
+      break;
+  }
+}
+
+// Only queues the request: the HTTPS round trip runs on the Pushsafer
+// task, outcomes come back through collectPushResults()
+void pushEventSink(const Event& event) {
+  switch (event.type) {
+    case EVT_DOOR_OPENED:
+      pushNotifier.post(NOTIFY_DOOR_OPENED, {event.reason});
+      break;
+    case EVT_DOOR_CLOSED:
+      pushNotifier.post(NOTIFY_DOOR_CLOSED, {event.reason});
+      break;
+    case EVT_VEHICLE_DETECTED:
+      pushNotifier.post(NOTIFY_VEHICLE_DETECTED, {event.value1});
+      break;
+    case EVT_FIRE_ALERT:
+      if (!pushNotifier.post(NOTIFY_FIRE_ALERT, {event.value1, event.level, event.value2}, event.trace)) {
+        tracer.abandon(event.trace);
+      }
+      break;
+    case EVT_EXTINGUISHER_ACTIVATED:
+      pushNotifier.post(NOTIFY_EXTINGUISHER);
+      break;
+    case EVT_HIGH_TEMPERATURE:
+      pushNotifier.post(NOTIFY_HIGH_TEMPERATURE, {event.value1});
+      break;
+    case EVT_HIGH_SMOKE:
+      pushNotifier.post(NOTIFY_HIGH_SMOKE, {event.level});
+      break;
+    case EVT_INTRUSION:
+      pushNotifier.post(NOTIFY_INTRUSION, {true, true});
+      break;
+    case EVT_ALARM_ON:
+      pushNotifier.post(NOTIFY_ALARM_ACTIVATED, {event.reason});
+      break;
+    case EVT_ALARM_OFF:
+      pushNotifier.post(NOTIFY_ALARM_DEACTIVATED, {event.reason});
+      break;
+    default:
+      break;
+  }
+}
+
+// Pushsafer outcomes, stamped on the send task; traces are only touched
+// from loop()
+void collectPushResults() {
+  PushResult result;
+  while (pushNotifier.takeResult(result)) {
+    if (result.id != NOTIFY_FIRE_ALERT) continue;
+
+    // A failed send is not a delivered alert: keep it out of the latency stats
+    if (result.ok) {
+      tracer.mark(result.tag, TRACE_DELIVERED, result.doneMicros);
+      tracer.finish(result.tag);
+    } else {
+      tracer.abandon(result.tag);
     }
+  }
+}
 
-    lastState = doorState;
+void cloudEventSink(const Event& event) {
+  switch (event.type) {
+    case EVT_DOOR_OPENED:
+      cloudLogger.queueEvent("DOOR", event.bay == 0 ? "OPENED" : "OPENED:" + String(event.bay));
+      break;
+    case EVT_DOOR_CLOSED:
+      cloudLogger.queueEvent("DOOR", event.bay == 0 ? "CLOSED" : "CLOSED:" + String(event.bay));
+      break;
+    case EVT_VEHICLE_DETECTED:
+      cloudLogger.queueEvent("VEHICLE_DETECTED", String(event.value1, 1));
+      break;
+    case EVT_FIRE_ALERT:
+      cloudLogger.queueEvent("FIRE_ALERT", "CRITICAL");
+      break;
+    case EVT_INTRUSION:
+      cloudLogger.queueEvent("INTRUSION", "CRITICAL");
+      break;
+    default:
+      break;
   }
 }
 
+void dashboardEventSink(const Event& event) {
+  switch (event.type) {
+    case EVT_DOOR_OPENED:       dashboard.pushDoorStatus(event.bay, "OPENED"); break;
+    case EVT_DOOR_CLOSED:       dashboard.pushDoorStatus(event.bay, "CLOSED"); break;
+    case EVT_FIRE_ALERT:        dashboard.pushAlarmStatus("FIRE_DETECTED"); break;
+    case EVT_INTRUSION:         dashboard.pushAlarmStatus("INTRUSION_DETECTED"); break;
+    case EVT_ALARM_ON:          dashboard.pushAlarmStatus("ON"); break;
+    case EVT_FIRE_CLEARED:
+    case EVT_INTRUSION_CLEARED:
+    case EVT_ALARM_OFF:         dashboard.pushAlarmStatus("OFF"); break;
+    default:                    break;
+  }
+}
+
+// Bay 0 keeps the legacy payload, other bays append ":<bay>"
+void publishBayStatus(const char* topic, const char* status, uint8_t bay) {
+  if (bay == 0) {
+    mqttClient.publish(topic, status);
+    return;
+  }
+  char payload[16];
+  snprintf(payload, sizeof(payload), "%s:%u", status, bay);
+  mqttClient.publish(topic, payload);
+}
+
+// "<STATE>,<cm/s>,<eta s>" (eta -1 = not approaching), ":<bay>" for bay > 0
+void publishApproach(const Event& event) {
+  char payload[48];
+  int len = snprintf(payload, sizeof(payload), "%s,%.1f,%.1f",
+                     ApproachTracker::stateName((ApproachState)event.level),
+                     event.value1, event.value2);
+  if (event.bay > 0) {
+    snprintf(payload + len, sizeof(payload) - len, ":%u", event.bay);
+  }
+  mqttClient.publish(TOPIC_VEHICLE_APPROACH, payload);
+}
+
 // Publish Sensor Data to MQTT
 void publishSensorData(const SensorData& data) {
-  if (!mqttClient.connected()) return;
-
-  mqttClient.publish(TOPIC_TEMPERATURE, String(data.temperatureDHT, 1).c_str());
-  mqttClient.publish(TOPIC_HUMIDITY, String(data.humidity, 1).c_str());
-  mqttClient.publish(TOPIC_SMOKE, String(data.smokeLevel).c_str());
-  mqttClient.publish(TOPIC_DISTANCE_OUT, String(data.distanceOutside, 1).c_str());
-  mqttClient.publish(TOPIC_DISTANCE_IN, String(data.distanceInside, 1).c_str());
-  mqttClient.publish(TOPIC_PIR, data.pirMotion ? "DETECTED" : "CLEAR");
+  sensorPublisher.publishSensorData(data);
 }
 
 // Initialize GPIO
 void initializeGPIO() {
-  pinMode(TRIG_OUTSIDE_PIN, OUTPUT);
-  pinMode(ECHO_OUTSIDE_PIN, INPUT);
-  pinMode(TRIG_INSIDE_PIN, OUTPUT);
-  pinMode(ECHO_INSIDE_PIN, INPUT);
-
   pinMode(LED_OUTSIDE_PIN, OUTPUT);
   pinMode(LED_INSIDE_PIN, OUTPUT);
   pinMode(BUZZER_PIN, OUTPUT);
@@ -438,7 +1076,7 @@ void initializeGPIO() {
   digitalWrite(LED_INSIDE_PIN, LOW);
   digitalWrite(BUZZER_PIN, LOW);
 
-  Serial.println("  GPIO initialized");
+  LOG_INFO("  GPIO initialized");
 }
 
 // Print Welcome Banner
@@ -6,12 +6,24 @@
 // ============================================
 
 ThingSpeakLogger::ThingSpeakLogger() {
-  apiKey = THINGSPEAK_API_KEY;
   serverUrl = "http://";
   serverUrl += THINGSPEAK_SERVER;
   serverUrl += "/update";
-  lastUploadTime = 0;
   uploadCount = 0;
+  channelTable = nullptr;
+  fieldTable = nullptr;
+  channelCount = 0;
+  fieldCount = 0;
+  eventChannel = -1;
+  memset(channels, 0, sizeof(channels));
+  for (uint8_t m = 0; m < CLOUD_METRIC_COUNT; m++) metrics[m] = NAN;
+  eventCount = 0;
+  overflowTypes = 0;
+  overflowOther = 0;
+  statusFolded = 0;
+  eventsQueued = 0;
+  eventsSummarised = 0;
+  eventsDelivered = 0;
   
   Serial.println("[ThingSpeak] Logger created");
 }
@@ -20,71 +32,143 @@ ThingSpeakLogger::ThingSpeakLogger() {
 // BEGIN
 // ============================================
 
-void ThingSpeakLogger::begin(String key) {
-  if (key.length() > 0) {
-    apiKey = key;
+void ThingSpeakLogger::begin(const CloudChannel* table, uint8_t count,
+                             const CloudField* fields, uint8_t fieldTotal) {
+  channelTable = table;
+  channelCount = min(count, (uint8_t)THINGSPEAK_MAX_CHANNELS);
+  fieldTable = fields;
+  fieldCount = fieldTotal;
+  eventChannel = -1;
+
+  if (count > THINGSPEAK_MAX_CHANNELS) {
+    LOG_WARN("[ThingSpeak] ⚠️ %u channels, only %d used", count, THINGSPEAK_MAX_CHANNELS);
+  }
+
+  uint8_t enabled = 0;
+  for (uint8_t c = 0; c < channelCount; c++) {
+    const char* key = channelTable[c].writeKey;
+    channels[c].enabled = key != nullptr && key[0] != '\0' &&
+                          strcmp(key, "YOUR_THINGSPEAK_WRITE_KEY") != 0;
+    if (channels[c].enabled) enabled++;
+  }
+
+  // Phase-shift the enabled channels so their uploads interleave
+  unsigned long now = millis();
+  uint8_t phase = 0;
+  for (uint8_t c = 0; c < channelCount; c++) {
+    const CloudChannel& channel = channelTable[c];
+    CloudChannelState& state = channels[c];
+    unsigned long interval = max(channel.interval, (unsigned long)THINGSPEAK_MIN_INTERVAL);
+
+    state.lastAttempt = 0;
+    state.nextDue = now + interval;
+
+    if (state.enabled) {
+      state.nextDue += phase++ * interval / enabled;
+      LOG_INFO("[ThingSpeak] Channel %s, key %.8s..., every %lu ms",
+               channel.name, channel.writeKey, interval);   // Show first 8 chars only
+    } else {
+      LOG_WARN("[ThingSpeak] ⚠️ Channel %s: write key not set, skipped", channel.name);
+    }
+  }
+
+  for (uint8_t f = 0; f < fieldCount; f++) {
+    const CloudField& field = fieldTable[f];
+    if (field.channel >= channelCount || field.field < 1 || field.field > 8) {
+      LOG_WARN("[ThingSpeak] ⚠️ Field map entry %u ignored (channel %u, field %u)",
+               f, field.channel, field.field);
+      continue;
+    }
+    if (field.metric == CLOUD_EVENTS_CARRIED && eventChannel < 0) {
+      eventChannel = field.channel;
+    }
+  }
+
+  if (eventChannel < 0 || !channels[eventChannel].enabled) {
+    LOG_WARN("[ThingSpeak] ⚠️ No enabled channel carries events, they stay queued");
+  }
+
+  LOG_INFO("[ThingSpeak] Initialized, %u channel(s), %u fields, server %s",
+           channelCount, fieldCount, THINGSPEAK_SERVER);
+}
+
+// ============================================
+// METRICS
+// ============================================
+
+void ThingSpeakLogger::updateSensorData(const SensorData& data) {
+  metrics[CLOUD_TEMPERATURE] = data.temperatureDHT;
+  metrics[CLOUD_HUMIDITY] = data.humidity;
+  metrics[CLOUD_SMOKE] = data.smokeLevel;
+  metrics[CLOUD_DISTANCE_OUT] = data.distanceOutside;
+  metrics[CLOUD_DISTANCE_IN] = data.distanceInside;
+  metrics[CLOUD_PIR] = data.pirMotion ? 1 : 0;
+}
+
+void ThingSpeakLogger::setMetric(CloudMetric metric, float value) {
+  if (metric < CLOUD_METRIC_COUNT) metrics[metric] = value;
+}
+
+// Event counters are only sent while events are pending
+float ThingSpeakLogger::metricValue(CloudMetric metric) {
+  uint16_t total;
+  switch (metric) {
+    case CLOUD_EVENTS_CARRIED:
+      total = pendingTotal();
+      return total > 0 ? total : NAN;
+    case CLOUD_EVENTS_SUMMARISED:
+      total = pendingTotal();
+      return total > 0 ? total - eventCount + statusFolded : NAN;
+    default:
+      return metrics[metric];
   }
-  
-  Serial.println("[ThingSpeak] Initialized");
-  Serial.print("   API Key: ");
-  Serial.println(apiKey.substring(0, 8) + "...");  // Show first 8 chars only
-  Serial.print("   Server: ");
-  Serial.println(THINGSPEAK_SERVER);
 }
 
 // ============================================
-// UPLOAD SENSOR DATA
+// UPLOAD
 // ============================================
 
-bool ThingSpeakLogger::uploadSensorData(const SensorData& data) {
-  // Check rate limit (ThingSpeak: minimum 15 seconds between updates)
+bool ThingSpeakLogger::uploadDue() {
   unsigned long now = millis();
-  if (now - lastUploadTime < 15000) {
-    Serial.println("[ThingSpeak] ⏱️ Rate limit - skipping upload");
-    return false;
+  int8_t due = -1;
+  long mostOverdue = -1;
+
+  for (uint8_t c = 0; c < channelCount; c++) {
+    const CloudChannelState& state = channels[c];
+    if (!state.enabled) continue;
+
+    // ThingSpeak: minimum 15 seconds between updates per channel
+    if (state.lastAttempt != 0 && now - state.lastAttempt < THINGSPEAK_MIN_INTERVAL) continue;
+
+    long overdue = (long)(now - state.nextDue);
+    if (overdue >= 0 && overdue > mostOverdue) {
+      mostOverdue = overdue;
+      due = c;
+    }
   }
+
+  if (due < 0) return false;
+  return upload(due, now);
+}
+
+bool ThingSpeakLogger::upload(uint8_t channel, unsigned long now) {
+  CloudChannelState& state = channels[channel];
+  const char* name = channelTable[channel].name;
   
   // Check WiFi
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[ThingSpeak] ❌ WiFi not connected");
+    LOG_WARN("[ThingSpeak] ❌ WiFi not connected");
     return false;
   }
   
-  // Check API key
-  if (apiKey == "YOUR_THINGSPEAK_WRITE_KEY" || apiKey.length() == 0) {
-    Serial.println("[ThingSpeak] ❌ API Key not set");
-    return false;
-  }
+  // Next slot on this channel, whatever the outcome
+  state.lastAttempt = now;
+  state.nextDue = now + max(channelTable[channel].interval, (unsigned long)THINGSPEAK_MIN_INTERVAL);
   
   HTTPClient http;
-  
-  // Build URL with query parameters
-  String url = serverUrl;
-  url += "?api_key=" + apiKey;
-  
-  // Field 1: Temperature (DHT22)
-  if (data.temperatureDHT > -900) {
-    url += "&field1=" + String(data.temperatureDHT, 2);
-  }
-  
-  // Field 2: Humidity
-  if (data.humidity > -900) {
-    url += "&field2=" + String(data.humidity, 2);
-  }
-  
-  // Field 3: Smoke Level
-  url += "&field3=" + String(data.smokeLevel);
-  
-  // Field 4: Distance Outside
-  url += "&field4=" + String(data.distanceOutside, 2);
-  
-  // Field 5: PIR Motion (0 or 1)
-  url += "&field5=" + String(data.pirMotion ? 1 : 0);
-  
-  // Field 6: Distance Inside
-  url += "&field6=" + String(data.distanceInside, 2);
-  
-  Serial.print("[ThingSpeak] 📤 Uploading data... ");
+  bool carriesEvents = (channel == eventChannel);
+  uint16_t carried = carriesEvents ? pendingTotal() : 0;
+  String url = buildUpdateUrl(channel);
   
   http.begin(url);
   http.setTimeout(10000);  // 10 second timeout
@@ -97,76 +181,172 @@ bool ThingSpeakLogger::uploadSensorData(const SensorData& data) {
     int entryId = response.toInt();
     
     if (entryId > 0) {
-      Serial.print("✅ Success! Entry ID: ");
-      Serial.println(entryId);
-      lastUploadTime = now;
+      LOG_INFO("[ThingSpeak] 📤 ✅ %s uploaded, entry ID %d, %u event(s)", name, entryId, carried);
+      state.uploads++;
       uploadCount++;
+      
+      // Everything pending went out, in detail or in the summary
+      if (carriesEvents) {
+        eventsDelivered += carried;
+        eventsSummarised += statusFolded;
+        eventCount = 0;
+        overflowTypes = 0;
+        overflowOther = 0;
+        statusFolded = 0;
+      }
       http.end();
       return true;
     } else {
-      Serial.println("❌ Failed");
-      Serial.print("   Response: ");
-      Serial.println(response);
+      LOG_WARN("[ThingSpeak] 📤 ❌ %s failed, response: %s", name, logCopy(response));
+      state.failures++;
       http.end();
       return false;
     }
   } else {
-    Serial.print("❌ HTTP error: ");
-    Serial.println(httpCode);
+    LOG_WARN("[ThingSpeak] 📤 ❌ %s HTTP error: %d", name, httpCode);
+    state.failures++;
     http.end();
     return false;
   }
 }
 
 // ============================================
-// UPLOAD EVENT
+// BUILD UPDATE URL
 // ============================================
 
-bool ThingSpeakLogger::uploadEvent(String eventType, String eventData) {
-  // Check rate limit
-  unsigned long now = millis();
-  if (now - lastUploadTime < 15000) {
-    return false;  // Skip silently for events
-  }
-  
-  if (WiFi.status() != WL_CONNECTED) {
-    return false;
-  }
-  
-  if (apiKey == "YOUR_THINGSPEAK_WRITE_KEY" || apiKey.length() == 0) {
-    return false;
-  }
-  
-  HTTPClient http;
+String ThingSpeakLogger::buildUpdateUrl(uint8_t channel) {
+  if (channel >= channelCount) return "";
   
+  // Build URL with query parameters
   String url = serverUrl;
-  url += "?api_key=" + apiKey;
-  url += "&status=" + eventType + ":" + eventData;
-  
-  Serial.print("[ThingSpeak] 📝 Logging event: ");
-  Serial.print(eventType);
-  Serial.print(" - ");
-  Serial.println(eventData);
+  url += "?api_key=";
+  url += channelTable[channel].writeKey;
   
-  http.begin(url);
-  http.setTimeout(10000);
-  int httpCode = http.GET();
+  // Status first: it decides how many events only make the summary
+  String status = "";
+  if (channel == eventChannel && pendingTotal() > 0) status = buildStatus(millis());
   
-  bool success = false;
-  if (httpCode > 0) {
-    String response = http.getString();
-    int entryId = response.toInt();
+  // Fields mapped to this channel; NAN (and legacy <= -900) values are left out
+  for (uint8_t f = 0; f < fieldCount; f++) {
+    const CloudField& field = fieldTable[f];
+    if (field.channel != channel || field.field < 1 || field.field > 8) continue;
     
-    if (entryId > 0) {
-      Serial.println("   ✅ Event logged");
-      lastUploadTime = now;
-      uploadCount++;
-      success = true;
-    }
+    float value = metricValue(field.metric);
+    if (!(value > -900)) continue;
+    
+    url += "&field" + String(field.field) + "=";
+    url += field.decimals > 0 ? String(value, (unsigned int)field.decimals) : String((long)value);
+  }
+  
+  // Status: events since the last upload on this channel
+  if (status.length() > 0) {
+    url += "&status=";
+    appendEncoded(url, status);
   }
   
-  http.end();
-  return success;
+  return url;
+}
+
+// ============================================
+// EVENT QUEUE
+// ============================================
+
+bool ThingSpeakLogger::queueEvent(const char* type, const String& data) {
+  eventsQueued++;
+
+  if (eventCount < THINGSPEAK_EVENT_QUEUE) {
+    CloudEvent& event = events[eventCount++];
+    event.type = type;
+    strlcpy(event.data, data.c_str(), sizeof(event.data));
+    event.timestamp = millis();
+    return true;
+  }
+
+  countOverflow(overflow, overflowTypes, overflowOther, type, 1);
+  eventsSummarised++;
+  LOG_DEBUG("[ThingSpeak] Event queue full, %s counted in summary", type);
+  return false;
+}
+
+void ThingSpeakLogger::countOverflow(CloudOverflow* table, uint8_t& types, uint16_t& other,
+                                     const char* type, uint16_t count) {
+  for (uint8_t i = 0; i < types; i++) {
+    if (strcmp(table[i].type, type) == 0) {
+      table[i].count += count;
+      return;
+    }
+  }
+
+  if (types < THINGSPEAK_OVERFLOW_TYPES) {
+    table[types].type = type;
+    table[types].count = count;
+    types++;
+  } else {
+    other += count;
+  }
+}
+
+uint16_t ThingSpeakLogger::pendingTotal() {
+  uint16_t total = eventCount + overflowOther;
+  for (uint8_t i = 0; i < overflowTypes; i++) total += overflow[i].count;
+  return total;
+}
+
+// "DOOR:OPENED(-12s);VEHICLE_DETECTED:85.3(-3s);+4 DOOR x3 FIRE_ALERT x1"
+// Events that do not fit are folded into the summary as well and
+// counted in statusFolded for CLOUD_EVENTS_SUMMARISED.
+String ThingSpeakLogger::buildStatus(unsigned long now) {
+  CloudOverflow folded[THINGSPEAK_OVERFLOW_TYPES];
+  memcpy(folded, overflow, sizeof(folded));
+  uint8_t types = overflowTypes;
+  uint16_t other = overflowOther;
+
+  String status = "";
+  statusFolded = 0;
+  for (uint8_t i = 0; i < eventCount; i++) {
+    const CloudEvent& event = events[i];
+    String item = String(event.type) + ":" + event.data +
+                  "(-" + String((now - event.timestamp) / 1000) + "s)";
+
+    if (status.length() + item.length() + 1 > THINGSPEAK_STATUS_MAX - THINGSPEAK_SUMMARY_RESERVE) {
+      countOverflow(folded, types, other, event.type, 1);
+      statusFolded++;
+      continue;
+    }
+    if (status.length() > 0) status += ";";
+    status += item;
+  }
+
+  uint16_t summarised = other;
+  for (uint8_t i = 0; i < types; i++) summarised += folded[i].count;
+
+  if (summarised > 0) {
+    if (status.length() > 0) status += ";";
+    status += "+" + String(summarised);
+    for (uint8_t i = 0; i < types; i++) {
+      status += " " + String(folded[i].type) + " x" + String(folded[i].count);
+    }
+    if (other > 0) status += " other x" + String(other);
+  }
+
+  if (status.length() > THINGSPEAK_STATUS_MAX) status = status.substring(0, THINGSPEAK_STATUS_MAX);
+  return status;
+}
+
+// Query-string escaping for the free-text status
+void ThingSpeakLogger::appendEncoded(String& url, const String& text) {
+  static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+  for (unsigned int i = 0; i < text.length(); i++) {
+    char c = text.charAt(i);
+    if (isalnum(c) || strchr("-_.~:;,()", c)) {
+      url += c;
+    } else {
+      url += '%';
+      url += HEX_DIGITS[(c >> 4) & 0xF];
+      url += HEX_DIGITS[c & 0xF];
+    }
+  }
 }
 
 // ============================================
@@ -179,5 +359,19 @@ int ThingSpeakLogger::getUploadCount() {
 
 void ThingSpeakLogger::resetCounter() {
   uploadCount = 0;
-  Serial.println("[ThingSpeak] Counter reset");
-}
\ No newline at end of file
+  LOG_INFO("[ThingSpeak] Counter reset");
+}
+
+void ThingSpeakLogger::printStats() {
+  LOG_INFO("[ThingSpeak] uploads=%d events queued=%lu delivered=%lu summarised=%lu pending=%u",
+           uploadCount, eventsQueued, eventsDelivered, eventsSummarised, pendingTotal());
+  for (uint8_t c = 0; c < channelCount; c++) {
+    const CloudChannelState& state = channels[c];
+    if (!state.enabled) {
+      LOG_INFO("[ThingSpeak]   %-10s off", channelTable[c].name);
+      continue;
+    }
+    LOG_INFO("[ThingSpeak]   %-10s uploads=%lu failures=%lu next in %ld ms",
+             channelTable[c].name, state.uploads, state.failures, (long)(state.nextDue - millis()));
+  }
+}
@@ -6,22 +6,87 @@
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include "config.h"
+#include "Logger.h"
 #include "SensorModule.h"
 
+// Event waiting for the next sensor upload.
+// `type` must point to a string literal - it is not copied.
+struct CloudEvent {
+  const char* type;
+  char data[THINGSPEAK_EVENT_DATA_SIZE];
+  unsigned long timestamp;
+};
+
+// Events that did not fit the queue, counted per type
+struct CloudOverflow {
+  const char* type;
+  uint16_t count;
+};
+
+// Rate-limit bookkeeping, one per CloudChannel
+struct CloudChannelState {
+  bool enabled;                 // write key set
+  unsigned long lastAttempt;
+  unsigned long nextDue;        // millis()
+  unsigned long uploads;
+  unsigned long failures;
+};
+
 class ThingSpeakLogger {
 private:
-  String apiKey;
   String serverUrl;
-  unsigned long lastUploadTime;
   int uploadCount;
-  
+
+  // Channels and field map (see CLOUD_CHANNELS / CLOUD_FIELDS)
+  const CloudChannel* channelTable;
+  const CloudField* fieldTable;
+  uint8_t channelCount;
+  uint8_t fieldCount;
+  int8_t eventChannel;          // -1 = events are not mapped
+  CloudChannelState channels[THINGSPEAK_MAX_CHANNELS];
+  float metrics[CLOUD_METRIC_COUNT];
+
+  // Pending events, carried by the next sensor upload
+  CloudEvent events[THINGSPEAK_EVENT_QUEUE];
+  uint8_t eventCount;
+  CloudOverflow overflow[THINGSPEAK_OVERFLOW_TYPES];
+  uint8_t overflowTypes;
+  uint16_t overflowOther;       // types beyond THINGSPEAK_OVERFLOW_TYPES
+  uint16_t statusFolded;        // queued events the last status had no room for
+  unsigned long eventsQueued;
+  unsigned long eventsSummarised;
+  unsigned long eventsDelivered;
+
+  static void countOverflow(CloudOverflow* table, uint8_t& types, uint16_t& other,
+                            const char* type, uint16_t count);
+  static void appendEncoded(String& url, const String& text);
+  String buildStatus(unsigned long now);
+  uint16_t pendingTotal();
+  float metricValue(CloudMetric metric);
+  bool upload(uint8_t channel, unsigned long now);
+
 public:
   ThingSpeakLogger();
-  void begin(String key);
-  bool uploadSensorData(const SensorData& data);
-  bool uploadEvent(String eventType, String eventData);
+  void begin(const CloudChannel* channels, uint8_t channelCount,
+             const CloudField* fields, uint8_t fieldCount);
+
+  // Latest values; NAN (e.g. a failed DHT22 read) leaves the field out
+  void updateSensorData(const SensorData& data);
+  void setMetric(CloudMetric metric, float value);
+
+  // Upload the most overdue channel, if any. Call every THINGSPEAK_TICK.
+  // Returns true after a successful upload.
+  bool uploadDue();
+  String buildUpdateUrl(uint8_t channel);
+
+  // Never uploads on its own: the event rides in the status field of
+  // the next sensor update. Returns false if only counted in the
+  // overflow summary.
+  bool queueEvent(const char* type, const String& data);
+
   int getUploadCount();
   void resetCounter();
+  void printStats();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -26,18 +26,59 @@
 #define TOPIC_ALARM_STATUS      "garage/alarm/status"
 #define TOPIC_ALARM_CMD         "garage/alarm/cmd"
 #define TOPIC_VEHICLE_DETECTED  "garage/vehicle/detected"  
+#define TOPIC_HISTORY_QUERY     "garage/history/query"
+#define TOPIC_HISTORY_REPLY     "garage/history/reply"
+#define TOPIC_VEHICLE_HINT      "garage/vehicle/hint"     // "[bay]" - owner arriving
+#define TOPIC_VEHICLE_APPROACH  "garage/vehicle/approach"
+#define TOPIC_GAS_CALIBRATE     "garage/gas/calibrate"    // run in clean air only
+#define TOPIC_GAS_CALIBRATION   "garage/gas/calibration"  // "OK,<R0>,<ADC>" or "FAILED"
+#define TOPIC_DIAG_LATENCY      "garage/diag/latency"          // per-trace hop breakdown
+#define TOPIC_DIAG_LATENCY_SUMMARY "garage/diag/latency/summary"
+#define TOPIC_DIAG_BENCH        "garage/diag/bench"            // one JSON object per case
+#define TOPIC_DIAG_BENCH_CMD    "garage/diag/bench/cmd"        // "RUN" | "SAVE" | "COMPARE"
+#define TOPIC_DIAG_BOOT         "garage/diag/boot"             // boot phases, retained
 
 // ============================================
 // PUSHSAFER CONFIGURATION
 // ============================================
 #define PUSHSAFER_API_KEY       "fkPI1VfJf8rTl3eQsLmD"
 #define PUSHSAFER_API_URL       "https://www.pushsafer.com/api"
+// Each notification opens its own TLS connection and closes it after
+// the response, so no dead idle socket or TLS context (~40 KB heap) is
+// left around. Only the session (a few hundred bytes, plus the peer
+// certificate if mbedTLS keeps it) is saved, so the next connect is an
+// abbreviated handshake while the server still accepts it. A TLS
+// warm-up runs at boot and whenever WiFi comes back, so an alert does
+// not pay for the full one. getTlsStats() counts and times both kinds.
+// To test on a LAN, point the URL at a stand-in such as
+// `openssl s_server -accept 4433 -WWW` ("https://<host>:4433/api").
+// Define PUSHSAFER_ROOT_CA (PEM) to verify the server certificate.
+// Without it the link is encrypted but unauthenticated, and begin()
+// only proceeds (with a warning) while PUSHSAFER_ALLOW_INSECURE is true.
+#define PUSHSAFER_ALLOW_INSECURE true
+#define PUSHSAFER_HANDSHAKE_TIMEOUT 10 // seconds
+#define PUSHSAFER_POST_SIZE     768    // request body, URL-encoded UTF-8
+// All sends run on one task: the event sink and the boot "online"
+// notice only queue a request, loop() collects the outcome (for latency
+// traces) afterwards. Emergencies jump the queue.
+#define PUSHSAFER_QUEUE_SIZE    8      // requests waiting for the send task
+#define PUSHSAFER_TASK_STACK    8192   // TLS + HTTP
+#define PUSHSAFER_TASK_PRIORITY 1      // same as loop()
 
 // ============================================
 // THINGSPEAK CONFIGURATION
 // ============================================
-#define THINGSPEAK_API_KEY      "R0466HY1GPPY1O2V"
+#define THINGSPEAK_API_KEY      "R0466HY1GPPY1O2V"            // channel "garage"
+#define THINGSPEAK_OCCUPANCY_KEY "YOUR_THINGSPEAK_WRITE_KEY"  // channel "occupancy", skipped until set
 #define THINGSPEAK_SERVER       "api.thingspeak.com"
+// Events never cost an extra request: they ride in the status field of
+// the next sensor update, with CLOUD_EVENTS_CARRIED / _SUMMARISED
+// counting all events and those only in the "+N" overflow summary.
+#define THINGSPEAK_EVENT_QUEUE  8
+#define THINGSPEAK_EVENT_DATA_SIZE 16
+#define THINGSPEAK_OVERFLOW_TYPES 6
+#define THINGSPEAK_STATUS_MAX   255    // characters
+#define THINGSPEAK_SUMMARY_RESERVE 64  // kept free for the overflow summary
 
 // ============================================
 // HARDWARE PIN DEFINITIONS
@@ -67,6 +108,28 @@
 #define DHT_PIN                 16
 #define GAS_SENSOR_PIN          34
 
+// ============================================
+// BAY LAYOUT
+// ============================================
+// One entry per parking bay. Bay 0 keeps the original single-door pins
+// and the legacy MQTT payloads; other bays are addressed as "<cmd>:<bay>".
+#define BAY_MAX                 8
+
+struct BayConfig {
+  int trigOutside;
+  int echoOutside;
+  int trigInside;
+  int echoInside;
+  int servoDoor;
+  int ledOutside;
+};
+
+static const BayConfig BAY_TABLE[] = {
+  { TRIG_OUTSIDE_PIN, ECHO_OUTSIDE_PIN, TRIG_INSIDE_PIN, ECHO_INSIDE_PIN, SERVO_DOOR_PIN, LED_OUTSIDE_PIN },
+};
+
+#define BAY_COUNT (sizeof(BAY_TABLE) / sizeof(BAY_TABLE[0]))
+
 // ============================================
 // SYSTEM THRESHOLDS
 // ============================================
@@ -74,21 +137,337 @@
 // Distance thresholds
 #define VEHICLE_DETECT_DISTANCE 100.0  // cm
 #define MAX_DISTANCE            400.0
+#define ULTRASONIC_TIMEOUT      ((uint32_t)(MAX_DISTANCE * 10 * 100 / 17))  // us, echo of MAX_DISTANCE
 
 // Temperature thresholds
 #define TEMP_WARNING_THRESHOLD  45.0   // °C
 #define TEMP_CRITICAL_THRESHOLD 60.0   // °C
 
 // Smoke/Gas thresholds
-#define SMOKE_WARNING_THRESHOLD 600    // ppm
+#define SMOKE_WARNING_THRESHOLD 600    // ppm (calibrated MQ-2 smoke curve)
 #define SMOKE_CRITICAL_THRESHOLD 800   // ppm
 
+// Gas sensor calibration (MQ-2)
+#define GAS_ADC_MAX             4095
+#define GAS_LOAD_RESISTOR       5000   // ohm, RL on the module
+#define GAS_CLEAN_AIR_RATIO_X100 983   // Rs/R0 in clean air (datasheet: 9.83)
+#define GAS_R0_DEFAULT          10000  // ohm, until calibrated
+#define GAS_CALIBRATION_SAMPLES 50
+#define GAS_CALIBRATION_INTERVAL 20    // ms between calibration samples (job period)
+#define GAS_PPM_MAX             10000  // upper end of the datasheet range
+
 // Timing
 #define WAIT_RESPONSE_TIME      10000  // 10 seconds
 #define SENSOR_READ_INTERVAL    5000   // 5 seconds
-#define THINGSPEAK_INTERVAL     20000  // 20 seconds (ThingSpeak limit: 15s)
+#define THINGSPEAK_INTERVAL     20000  // 20 seconds per channel (ThingSpeak limit: 15s)
+#define THINGSPEAK_MIN_INTERVAL 15000  // per-channel floor, also after a failure
+#define THINGSPEAK_TICK         1000   // at most one upload per tick
 #define MQTT_RETRY_INTERVAL     5000   // 5 seconds
-#define DISTANCE_CHECK_INTERVAL 2000   // 2 seconds
+#define WIFI_LINK_CHECK_INTERVAL 2000  // WiFi back up -> Pushsafer TLS warm-up
+#define BAY_PING_GAP            60     // ms between pings within a sweep
+#define BAY_SWEEP_INTERVAL      250    // ms between sweep starts, rounded up to pings
+#define ALARM_BLINK_INTERVAL    200
+#define VEHICLE_ALERT_TIME      5000   // LED + buzzer after WAIT_RESPONSE_TIME
+#define EXTINGUISHER_HOLD_TIME  5000
+
+// Door servo sweep
+#define DOOR_OPEN_ANGLE         160
+#define DOOR_STEP_ANGLE         5
+#define DOOR_STEP_INTERVAL      15     // ms per step
+
+// ============================================
+// ALARM RULES
+// ============================================
+// Each rule ORs (RULE_ANY) or ANDs (RULE_ALL) up to RULE_MAX_TERMS terms.
+// A term compares an aggregate of the last `window` samples of one input;
+// it latches above `enter` and releases below `exit` (reversed for
+// RULE_BELOW). The rule fires after holding for `minDuration` ms, repeats
+// every `repeat` ms while held (0 = once) and clears when it drops.
+// Unused terms have window 0.
+#define RULE_MAX_RULES          16
+#define RULE_MAX_TERMS          2
+#define RULE_WINDOW_MAX         8      // samples per input
+
+#define TEMP_HYSTERESIS         2.0    // °C
+#define SMOKE_HYSTERESIS        50     // ppm
+
+enum RuleInput : uint8_t {
+  RULE_IN_TEMPERATURE,
+  RULE_IN_HUMIDITY,
+  RULE_IN_SMOKE,
+  RULE_IN_PIR,
+  RULE_IN_DOORS_CLOSED,
+  RULE_IN_COUNT
+};
+
+enum RuleAggregate : uint8_t { RULE_AGG_LAST, RULE_AGG_MEAN, RULE_AGG_MIN, RULE_AGG_MAX };
+enum RuleCompare : uint8_t { RULE_ABOVE, RULE_BELOW };
+enum RuleJoin : uint8_t { RULE_ANY, RULE_ALL };
+
+enum RuleAction : uint8_t {
+  RULE_ACTION_FIRE,
+  RULE_ACTION_HIGH_TEMPERATURE,
+  RULE_ACTION_HIGH_SMOKE,
+  RULE_ACTION_INTRUSION
+};
+
+struct RuleTerm {
+  RuleInput input;
+  RuleAggregate aggregate;
+  uint8_t window;
+  RuleCompare compare;
+  float enter;
+  float exit;
+};
+
+struct AlarmRule {
+  const char* name;
+  RuleAction action;
+  RuleJoin join;
+  unsigned long minDuration;
+  unsigned long repeat;
+  RuleTerm terms[RULE_MAX_TERMS];
+};
+
+static const AlarmRule ALARM_RULES[] = {
+  // Fire: immediate, re-armed once the extinguisher cycle is over;
+  // clears only when both readings are back under the warning level
+  { "fire", RULE_ACTION_FIRE, RULE_ANY, 0, EXTINGUISHER_HOLD_TIME + SENSOR_READ_INTERVAL, {
+      { RULE_IN_TEMPERATURE, RULE_AGG_LAST, 1, RULE_ABOVE, TEMP_CRITICAL_THRESHOLD, TEMP_WARNING_THRESHOLD },
+      { RULE_IN_SMOKE, RULE_AGG_LAST, 1, RULE_ABOVE, SMOKE_CRITICAL_THRESHOLD, SMOKE_WARNING_THRESHOLD } } },
+  { "high-temp", RULE_ACTION_HIGH_TEMPERATURE, RULE_ANY, 10000, 0, {
+      { RULE_IN_TEMPERATURE, RULE_AGG_MEAN, 3, RULE_ABOVE,
+        TEMP_WARNING_THRESHOLD, TEMP_WARNING_THRESHOLD - TEMP_HYSTERESIS } } },
+  { "high-smoke", RULE_ACTION_HIGH_SMOKE, RULE_ANY, 10000, 0, {
+      { RULE_IN_SMOKE, RULE_AGG_MEAN, 3, RULE_ABOVE,
+        SMOKE_WARNING_THRESHOLD, SMOKE_WARNING_THRESHOLD - SMOKE_HYSTERESIS } } },
+  { "intrusion", RULE_ACTION_INTRUSION, RULE_ALL, 0, 0, {
+      { RULE_IN_PIR, RULE_AGG_LAST, 1, RULE_ABOVE, 0.5, 0.5 },
+      { RULE_IN_DOORS_CLOSED, RULE_AGG_LAST, 1, RULE_ABOVE, 0.5, 0.5 } } },
+};
+
+#define ALARM_RULE_COUNT (sizeof(ALARM_RULES) / sizeof(ALARM_RULES[0]))
+
+// ============================================
+// THINGSPEAK CHANNELS
+// ============================================
+// Every channel has its own write key and rate limit, so metrics are
+// sharded over channels and the uploads interleaved: channel i starts
+// i * interval / count later, and each THINGSPEAK_TICK uploads at most
+// the most overdue channel. A metric may map to several channels. The
+// event status rides on the channel carrying CLOUD_EVENTS_CARRIED.
+#define THINGSPEAK_MAX_CHANNELS 4
+
+enum CloudMetric : uint8_t {
+  CLOUD_TEMPERATURE,
+  CLOUD_HUMIDITY,
+  CLOUD_SMOKE,
+  CLOUD_DISTANCE_OUT,
+  CLOUD_DISTANCE_IN,
+  CLOUD_PIR,
+  CLOUD_EVENTS_CARRIED,
+  CLOUD_EVENTS_SUMMARISED,
+  CLOUD_VEHICLES,               // bays with a vehicle present
+  CLOUD_DOORS_OPEN,             // doors not fully closed
+  CLOUD_ALARM,                  // AlarmState
+  CLOUD_METRIC_COUNT
+};
+
+struct CloudChannel {
+  const char* name;
+  const char* writeKey;
+  unsigned long interval;       // ms, at least THINGSPEAK_MIN_INTERVAL
+};
+
+struct CloudField {
+  CloudMetric metric;
+  uint8_t channel;              // index into CLOUD_CHANNELS
+  uint8_t field;                // 1-8
+  uint8_t decimals;
+};
+
+static const CloudChannel CLOUD_CHANNELS[] = {
+  { "garage",    THINGSPEAK_API_KEY,       THINGSPEAK_INTERVAL },
+  { "occupancy", THINGSPEAK_OCCUPANCY_KEY, THINGSPEAK_INTERVAL },
+};
+
+static const CloudField CLOUD_FIELDS[] = {
+  // garage: the original single-channel layout
+  { CLOUD_TEMPERATURE,       0, 1, 2 },
+  { CLOUD_HUMIDITY,          0, 2, 2 },
+  { CLOUD_SMOKE,             0, 3, 0 },
+  { CLOUD_DISTANCE_OUT,      0, 4, 2 },
+  { CLOUD_PIR,               0, 5, 0 },
+  { CLOUD_DISTANCE_IN,       0, 6, 2 },
+  { CLOUD_EVENTS_CARRIED,    0, 7, 0 },
+  { CLOUD_EVENTS_SUMMARISED, 0, 8, 0 },
+  // occupancy: door/bay state, plus the presence sensors at twice the rate
+  { CLOUD_VEHICLES,          1, 1, 0 },
+  { CLOUD_DOORS_OPEN,        1, 2, 0 },
+  { CLOUD_ALARM,             1, 3, 0 },
+  { CLOUD_DISTANCE_OUT,      1, 4, 2 },
+  { CLOUD_DISTANCE_IN,       1, 5, 2 },
+  { CLOUD_PIR,               1, 6, 0 },
+};
+
+#define CLOUD_CHANNEL_COUNT (sizeof(CLOUD_CHANNELS) / sizeof(CLOUD_CHANNELS[0]))
+#define CLOUD_FIELD_COUNT (sizeof(CLOUD_FIELDS) / sizeof(CLOUD_FIELDS[0]))
+
+// ============================================
+// APPROACH TRACKING / PREDICTIVE OPENING
+// ============================================
+#define APPROACH_PREOPEN        false  // open ahead of hinted arrivals
+#define APPROACH_HISTORY        8      // samples per bay (one per sweep)
+#define APPROACH_MIN_SAMPLES    4
+// Enter/exit pairs are hysteresis bands: a target hovering at the range
+// edge or at the speed threshold would otherwise flip state every sweep
+#define APPROACH_RANGE          300.0  // cm, a track starts nearer than this
+#define APPROACH_RANGE_EXIT     320.0  // cm, and ends farther than this
+#define APPROACH_GAP            1000   // ms without echo resets the track
+#define APPROACH_ENTER_SPEED    15.0   // cm/s to start approaching/departing
+#define APPROACH_EXIT_SPEED     8.0    // cm/s, slower = stationary again
+#define APPROACH_EVENT_MIN_GAP  1000   // ms between approach events per bay
+#define APPROACH_HINT_WINDOW    120000 // hint authorises an opening for 2 min
+#define APPROACH_PREOPEN_LEAD   1500   // ms ETA at which to start the sweep
+#define APPROACH_PREOPEN_TIMEOUT 15000 // no arrival by then = false pre-open
+
+// ============================================
+// LOGGING
+// ============================================
+// Records are queued (format ID + raw args) and printed by a task
+// below loop() priority, so Serial at 9600 baud no longer blocks.
+#define LOG_LEVEL_NONE          0
+#define LOG_LEVEL_ERROR         1
+#define LOG_LEVEL_WARN          2
+#define LOG_LEVEL_INFO          3
+#define LOG_LEVEL_DEBUG         4
+
+#define LOG_LEVEL               LOG_LEVEL_INFO   // higher levels are compiled out
+#define LOG_RING_SIZE           64     // records, power of two
+#define LOG_MAX_ARGS            6
+#define LOG_TEXT_SIZE           48     // logCopy() bytes per record
+#define LOG_LINE_SIZE           160
+#define LOG_TASK_STACK          4096
+#define LOG_TASK_PRIORITY       0      // loop() runs at 1
+#define LOG_IDLE_DELAY          20     // ms between polls when empty
+
+// ============================================
+// LATENCY TRACING
+// ============================================
+// Door commands sent as "OPEN#<id>" are traced from MQTT receipt to
+// the published door status; fire alerts from the sample to Pushsafer.
+#define TRACE_MAX_ACTIVE        8
+#define TRACE_ID_SIZE           12     // correlation ID incl. terminator
+#define TRACE_SAMPLES           64     // recent totals per kind; p99 here is ~max,
+                                       // host/tools/latency_collector.py keeps all
+#define TRACE_TIMEOUT           30000  // ms before an open trace is dropped
+#define TRACE_FIRE_ALERTS       true
+
+// ============================================
+// SCHEDULER
+// ============================================
+// Hashed timer wheel: 64 slots x 10 ms = 640 ms per revolution,
+// longer periods wrap with a round counter.
+#define SCHED_TICK_MS           10
+#define SCHED_WHEEL_SLOTS       64
+#define SCHED_FIXED_JOBS        16     // periodic jobs + single one-shots, with headroom
+#define SCHED_MAX_JOBS          (SCHED_FIXED_JOBS + BAY_MAX)  // + one vehicle-alert per bay
+#define SCHED_RETRY_MAX         4      // one-shots waiting for a free job slot
+#define SCHED_IDLE_MAX          10     // max sleep per loop() pass (ms)
+
+// ============================================
+// BOOT
+// ============================================
+// setup() only brings up GPIO, servos and sensing. WiFi, dashboard,
+// Pushsafer and boot benchmarks run afterwards as deferred stages, one
+// step per "boot" job run, so fire/intrusion checks start right away.
+#define BOOT_MAX_STAGES         8
+#define BOOT_STAGE_INTERVAL     50     // ms between stage steps
+#define BOOT_WIFI_WARN          10000  // ms; warn once if WiFi is still down
+#define BOOT_REPORT_WAIT        30000  // ms after the stages for the first ThingSpeak upload
+
+// ============================================
+// REPORT-BY-EXCEPTION PUBLISHING
+// ============================================
+#define REPORT_BY_EXCEPTION     true   // false = publish every sample
+#define DEADBAND_TEMPERATURE    0.2    // °C
+#define DEADBAND_HUMIDITY       1.0    // %
+#define DEADBAND_SMOKE          10     // ppm
+#define DEADBAND_DISTANCE       2.0    // cm
+#define DEADBAND_PIR            0.5    // any change
+#define PUBLISH_MAX_SILENCE     60000  // heartbeat, 60 seconds
+#define PUBLISH_RETAINED        true
+#define DEADBAND_MAX_CHANNELS   8
+
+// ============================================
+// MICROBENCHMARKS
+// ============================================
+// Hot-path cost on the target itself: each case is repeated until it
+// has run BENCH_MIN_TIME ms, best of BENCH_REPETITIONS. SAVE stores the
+// result as baseline in NVS, COMPARE flags cases slower by more than
+// BENCH_REGRESSION_PCT. Blocks loop() for roughly a second.
+// The same cases build on a PC (host/, Google Benchmark) where
+// bench-check fails the build on a regression and counts allocations.
+#define BENCH_MODE_OFF          0
+#define BENCH_MODE_RUN          1
+#define BENCH_MODE_SAVE         2
+#define BENCH_MODE_COMPARE      3
+
+#define BENCH_BOOT_MODE         BENCH_MODE_OFF
+#define BENCH_MAX_CASES         16
+#define BENCH_MIN_TIME          20     // ms per repetition
+#define BENCH_REPETITIONS       3
+#define BENCH_REGRESSION_PCT    10
+
+// ============================================
+// EVENT BUS
+// ============================================
+#define EVENT_POOL_SIZE         16     // events in flight
+#define EVENT_MAX_SINKS         4
+#define EVENT_SINK_QUEUE_SIZE   16     // per-sink backlog
+#define EVENT_BATCH_MQTT        8      // events per dispatch
+#define EVENT_BATCH_PUSH        4      // only queued for the Pushsafer task
+#define EVENT_BATCH_CLOUD       1
+#define EVENT_STATS_INTERVAL    60000  // 60 seconds
+
+// ============================================
+// ON-DEVICE HISTORY
+// ============================================
+#define HISTORY_RAW_SIZE        120    // 10 min of 5 s samples
+#define HISTORY_MINUTE_SIZE     60     // 1 hour of 1-minute rollups
+#define HISTORY_HOUR_SIZE       24     // 1 day of 1-hour rollups
+#define HISTORY_REPLY_ROWS      16     // rows per reply message
+#define MQTT_BUFFER_SIZE        512    // bytes (PubSubClient default: 256)
+
+// ============================================
+// LOCAL DASHBOARD
+// ============================================
+#define DASHBOARD_PORT          80
+#define DASHBOARD_MAX_CLIENTS   4
+#define DASHBOARD_QUEUE_SIZE    8      // pending commands from clients
+#define DASHBOARD_FRAME_MAX     32     // command frame incl. terminator
+
+// ============================================
+// FLEET SIMULATOR (broker load testing)
+// ============================================
+// Each virtual garage holds its own TCP session; lwIP allows ~10
+// sockets, so on the board this is a smoke test. Hundreds of garages
+// run from the host build (host/fleet) against a local mosquitto.
+// begin() refuses MQTT_SERVER: the public broker is not a load target.
+#define FLEET_SIM_ENABLED       0
+#define FLEET_SIM_BROKER        "localhost"   // on the board: the test broker's LAN address
+#define FLEET_SIM_PORT          1883
+#ifndef FLEET_SIM_GARAGES
+#define FLEET_SIM_GARAGES       6             // host build sets its own
+#endif
+#define FLEET_SIM_SAMPLE_INTERVAL 1000        // ms per virtual sample
+#define FLEET_SIM_PHASE_MS      30000         // scenario length
+#define FLEET_SIM_SERVO_MS      500           // simulated door sweep
+#define FLEET_SIM_DOOR_HOLD     5000          // operator closes after
+#define FLEET_SIM_CHURN_INTERVAL 5000         // ms between forced reconnects, 0 = off
+#define FLEET_SIM_RTT_SAMPLES   128
+#define FLEET_SIM_REPORT_INTERVAL 10000
+#define TOPIC_FLEET_SIM_REPORT  "sim/report"
 
 // ============================================
 // DOOR STATES